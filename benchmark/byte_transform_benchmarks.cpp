@@ -0,0 +1,80 @@
+#include <arba/cryp/byte_transform.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+std::vector<uint8_t> random_bytes(std::size_t size, unsigned seed)
+{
+    std::mt19937 engine(seed);
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t& byte : bytes)
+        byte = static_cast<uint8_t>(engine());
+    return bytes;
+}
+
+// One keystream period, and a block bigger than the L2 cache.
+void transform_sizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgName("size")->Arg(2304)->Arg(64 * 1024)->Arg(16 * 1024 * 1024);
+}
+
+using bytes_function = void (*)(const uint8_t*, uint8_t*, const uint8_t*, std::size_t, cryp::instruction_set);
+using mode_bytes_function = void (*)(const uint8_t*, uint8_t*, const uint8_t*, std::size_t, cryp::byte_transform_mode);
+
+template <class TransformFunction>
+void run_transform_benchmark(benchmark::State& state, TransformFunction transform)
+{
+    const std::vector<uint8_t> input = random_bytes(state.range(0), 1);
+    const std::vector<uint8_t> crypto_offsets = random_bytes(input.size(), 2);
+    std::vector<uint8_t> output(input.size());
+    for (auto _ : state)
+    {
+        transform(input.data(), output.data(), crypto_offsets.data(), input.size());
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+} // namespace
+
+// Arithmetic mode, with each instruction set.
+static void BM_byte_transform_instruction_set(benchmark::State& state, bytes_function function,
+                                              cryp::instruction_set iset)
+{
+    if (!cryp::instruction_set_is_supported(iset))
+    {
+        state.SkipWithError("instruction set not supported");
+        return;
+    }
+    run_transform_benchmark(state, [&](const uint8_t* input, uint8_t* output, const uint8_t* offsets, std::size_t size)
+                            { function(input, output, offsets, size, iset); });
+}
+BENCHMARK_CAPTURE(BM_byte_transform_instruction_set, encrypt_scalar, &cryp::encrypt_bytes,
+                  cryp::instruction_set::scalar)
+    ->Apply(transform_sizes);
+BENCHMARK_CAPTURE(BM_byte_transform_instruction_set, encrypt_sse4, &cryp::encrypt_bytes, cryp::instruction_set::sse4)
+    ->Apply(transform_sizes);
+BENCHMARK_CAPTURE(BM_byte_transform_instruction_set, encrypt_avx2, &cryp::encrypt_bytes, cryp::instruction_set::avx2)
+    ->Apply(transform_sizes);
+BENCHMARK_CAPTURE(BM_byte_transform_instruction_set, encrypt_avx512, &cryp::encrypt_bytes,
+                  cryp::instruction_set::avx512)
+    ->Apply(transform_sizes);
+BENCHMARK_CAPTURE(BM_byte_transform_instruction_set, decrypt_scalar, &cryp::decrypt_bytes,
+                  cryp::instruction_set::scalar)
+    ->Apply(transform_sizes);
+BENCHMARK_CAPTURE(BM_byte_transform_instruction_set, decrypt_avx512, &cryp::decrypt_bytes,
+                  cryp::instruction_set::avx512)
+    ->Apply(transform_sizes);
+
+// Lookup table mode: it is worth it where it beats the scalar arithmetic kernel and no vector kernel is available.
+static void BM_byte_transform_lookup_table(benchmark::State& state, mode_bytes_function function)
+{
+    run_transform_benchmark(state, [&](const uint8_t* input, uint8_t* output, const uint8_t* offsets, std::size_t size)
+                            { function(input, output, offsets, size, cryp::byte_transform_mode::lookup_table); });
+}
+BENCHMARK_CAPTURE(BM_byte_transform_lookup_table, encrypt, &cryp::encrypt_bytes)->Apply(transform_sizes);
+BENCHMARK_CAPTURE(BM_byte_transform_lookup_table, decrypt, &cryp::decrypt_bytes)->Apply(transform_sizes);
@@ -0,0 +1,150 @@
+#include <arba/cryp/basic_symcrypt.hpp>
+#include <arba/cryp/symcrypt.hpp>
+
+#include <arba/rand/urng.hpp>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+const cryp::symcrypt_base::crypto_key key{ 0x37, 0xc5, 0x25, 0xc7, 0x08, 0xf6, 0x4c, 0xd1,
+                                           0x8a, 0xff, 0xea, 0x3e, 0x38, 0xea, 0xec, 0x87 };
+
+enum policy_index : int64_t
+{
+    sequential,
+    parallel,
+};
+
+cryp::execution_policy make_policy(int64_t index)
+{
+    return index == parallel ? cryp::execution_policy::parallel() : cryp::execution_policy::sequential();
+}
+
+std::vector<std::byte> make_data(std::size_t size)
+{
+    std::vector<std::byte> data(size);
+    rand::urng_u8<0, 255> rng(size);
+    std::ranges::generate(data, [&rng] { return static_cast<std::byte>(rng()); });
+    return data;
+}
+
+// Sizes from 0 bytes to 1 GiB, with both policies.
+void data_sizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({ "size", "parallel" });
+    for (int64_t policy : { sequential, parallel })
+    {
+        benchmark->Args({ 0, policy });
+        for (int64_t size = 16; size < int64_t(1) << 30; size *= 16)
+            benchmark->Args({ size, policy });
+        // 1 GiB (2^30) is not a power of 16.
+        benchmark->Args({ int64_t(1) << 30, policy });
+    }
+}
+
+void set_processed_bytes(benchmark::State& state, std::size_t size)
+{
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(size));
+}
+} // namespace
+
+static void BM_symcrypt_encrypt(benchmark::State& state)
+{
+    const std::vector<std::byte> data = make_data(state.range(0));
+    const cryp::execution_policy policy = make_policy(state.range(1));
+    std::vector<std::byte> output(cryp::symcrypt::encrypted_size(data.size()));
+    cryp::symcrypt symcrypt(key);
+    for (auto _ : state)
+    {
+        symcrypt.encrypt(data, output, policy);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed_bytes(state, data.size());
+}
+BENCHMARK(BM_symcrypt_encrypt)->Apply(data_sizes)->UseRealTime();
+
+static void BM_symcrypt_decrypt(benchmark::State& state)
+{
+    const cryp::execution_policy policy = make_policy(state.range(1));
+    std::vector<std::byte> data = make_data(state.range(0));
+    std::vector<std::byte> encrypted_data(cryp::symcrypt::encrypted_size(data.size()));
+    cryp::symcrypt symcrypt(key);
+    symcrypt.encrypt(data, encrypted_data, policy);
+    for (auto _ : state)
+    {
+        symcrypt.decrypt(encrypted_data, data, policy);
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed_bytes(state, data.size());
+}
+BENCHMARK(BM_symcrypt_decrypt)->Apply(data_sizes)->UseRealTime();
+
+// Re-encryption with the same key, so that the data stays decryptable from one iteration to the next.
+static void BM_symcrypt_reencrypt(benchmark::State& state)
+{
+    const cryp::execution_policy policy = make_policy(state.range(1));
+    const std::vector<std::byte> data = make_data(state.range(0));
+    std::vector<std::byte> encrypted_data(cryp::symcrypt::encrypted_size(data.size()));
+    cryp::symcrypt symcrypt(key);
+    symcrypt.encrypt(data, encrypted_data, policy);
+    for (auto _ : state)
+    {
+        symcrypt.reencrypt(key, encrypted_data, policy);
+        benchmark::DoNotOptimize(encrypted_data.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed_bytes(state, data.size());
+}
+BENCHMARK(BM_symcrypt_reencrypt)->Apply(data_sizes)->UseRealTime();
+
+// The cost of the random bytes only matters for small data.
+template <class SymcryptType>
+static void BM_symcrypt_encrypt_rng(benchmark::State& state, SymcryptType symcrypt)
+{
+    const std::vector<std::byte> data = make_data(state.range(0));
+    std::vector<std::byte> output(cryp::symcrypt::encrypted_size(data.size()));
+    for (auto _ : state)
+    {
+        symcrypt.encrypt(data, output, cryp::execution_policy::sequential());
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed_bytes(state, data.size());
+}
+BENCHMARK_CAPTURE(BM_symcrypt_encrypt_rng, urng_u8, cryp::symcrypt(key, rand::urng_u8<0, 255>{}))
+    ->ArgName("size")->Arg(0)->Arg(20)->Arg(1024);
+BENCHMARK_CAPTURE(BM_symcrypt_encrypt_rng, random_bytes_function,
+                  cryp::symcrypt(key, cryp::random_bytes_function(cryp::thread_local_random_bytes{})))
+    ->ArgName("size")->Arg(0)->Arg(20)->Arg(1024);
+BENCHMARK_CAPTURE(BM_symcrypt_encrypt_rng, thread_local_random_bytes, cryp::basic_symcrypt<>(key))
+    ->ArgName("size")->Arg(0)->Arg(20)->Arg(1024);
+
+static void BM_symcrypt_encrypt_batch(benchmark::State& state)
+{
+    const std::size_t message_count = 10000;
+    const std::vector<std::byte> data = make_data(state.range(0) * message_count);
+    std::vector<std::span<const std::byte>> messages;
+    for (std::size_t i = 0; i < message_count; ++i)
+        messages.push_back(std::span(data).subspan(i * state.range(0), state.range(0)));
+    const cryp::execution_policy policy = make_policy(state.range(1));
+    std::vector<std::byte> output(cryp::symcrypt::encrypted_batch_size(messages));
+    cryp::basic_symcrypt<> symcrypt(key);
+    for (auto _ : state)
+    {
+        symcrypt.encrypt_batch(messages, output, policy);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    set_processed_bytes(state, data.size());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * message_count));
+}
+BENCHMARK(BM_symcrypt_encrypt_batch)
+    ->ArgNames({ "message_size", "parallel" })
+    ->ArgsProduct({ { 20, 256 }, { sequential, parallel } })
+    ->UseRealTime();
@@ -28,14 +28,16 @@ class ArbaCrypRecipe(ConanFile):
         "fPIC": [True, False],
         "test": [True, False],
         "parallel_execution": [True, False],
-        "use_system_tbb": [True, False]
+        "use_system_tbb": [True, False],
+        "instrumentation": [True, False]
     }
     default_options = {
         "shared": True,
         "fPIC": True,
         "test": False,
         "parallel_execution": False,
-        "use_system_tbb": False
+        "use_system_tbb": False,
+        "instrumentation": False
     }
 
     # Build
@@ -74,6 +76,7 @@ class ArbaCrypRecipe(ConanFile):
         upper_name = f"{self.project_namespace}_{self.project_base_name}".upper()
         tc.variables[f"{upper_name}_LIBRARY_TYPE"] = "SHARED" if self.options.shared else "STATIC"
         tc.variables[f"{upper_name}_PARALLEL_EXECUTION"] = "ON" if self.options.parallel_execution else "OFF"
+        tc.variables[f"{upper_name}_INSTRUMENTATION"] = "ON" if self.options.instrumentation else "OFF"
         if self.options.test:
             tc.variables[f"BUILD_{upper_name}_TESTS"] = "TRUE"
         tc.generate()
@@ -0,0 +1,91 @@
+#include <arba/cryp/symcrypt.hpp>
+#include <arba/cryp/symcrypt_file.hpp>
+
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string_view>
+
+namespace
+{
+void print_usage(std::ostream& stream)
+{
+    stream << "Usage: arba-cryp (encrypt|decrypt) <input-file> <output-file> [options]\n"
+              "       arba-cryp (encrypt|decrypt) <input-directory> <output-directory> [options]\n"
+              "Options:\n"
+              "  --password <password>  Password used to derive the key.\n"
+              "                         The environment variable ARBA_CRYP_PASSWORD is used otherwise.\n"
+              "  --sequential           Do not use several threads.\n";
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        print_usage(std::cerr);
+        return EXIT_FAILURE;
+    }
+
+    const std::string_view command(argv[1]);
+    const std::filesystem::path input_path(argv[2]);
+    const std::filesystem::path output_path(argv[3]);
+    std::optional<std::string_view> password;
+    cryp::execution_policy policy = cryp::execution_policy::automatic();
+    for (int i = 4; i < argc; ++i)
+    {
+        const std::string_view option(argv[i]);
+        if (option == "--password" && i + 1 < argc)
+            password = argv[++i];
+        else if (option == "--sequential")
+            policy = cryp::execution_policy::sequential();
+        else
+        {
+            print_usage(std::cerr);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!password)
+    {
+        if (const char* env_password = std::getenv("ARBA_CRYP_PASSWORD"))
+            password = env_password;
+    }
+    if (!password || password->empty())
+    {
+        std::cerr << "arba-cryp: no password given." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        cryp::symcrypt symcrypt(*password);
+        if (command != "encrypt" && command != "decrypt")
+        {
+            print_usage(std::cerr);
+            return EXIT_FAILURE;
+        }
+        if (std::filesystem::is_directory(input_path))
+        {
+            // The files of the directory tree are processed together.
+            cryp::bulk_file_job job(symcrypt);
+            job.add_directory(input_path, output_path);
+            if (command == "encrypt")
+                job.encrypt(policy);
+            else
+                job.decrypt(policy);
+        }
+        else if (command == "encrypt")
+            cryp::encrypt_file(symcrypt, input_path, output_path, policy);
+        else
+            cryp::decrypt_file(symcrypt, input_path, output_path, policy);
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << "arba-cryp: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
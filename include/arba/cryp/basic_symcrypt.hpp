@@ -0,0 +1,47 @@
+#pragma once
+
+#include <arba/cryp/random_bytes.hpp>
+#include <arba/cryp/symcrypt_base.hpp>
+
+#include <utility>
+
+inline namespace arba
+{
+namespace cryp
+{
+// symcrypt storing its random bytes generator by value, without the type erasure of a std::function.
+// An encryption makes one virtual call to get its random bytes, whose final override calls the generator directly.
+template <random_bytes_generator GeneratorType = thread_local_random_bytes>
+class basic_symcrypt : public symcrypt_base
+{
+public:
+    using generator_type = GeneratorType;
+
+public:
+    explicit basic_symcrypt(const crypto_key& key, generator_type rng = generator_type())
+        : symcrypt_base(key), random_bytes_generator_(std::move(rng))
+    {
+    }
+
+    explicit basic_symcrypt(const std::string_view& key, generator_type rng = generator_type())
+        : symcrypt_base(key), random_bytes_generator_(std::move(rng))
+    {
+    }
+
+    explicit basic_symcrypt(std::shared_ptr<const key_schedule> schedule, generator_type rng = generator_type())
+        : symcrypt_base(std::move(schedule)), random_bytes_generator_(std::move(rng))
+    {
+    }
+
+    inline const generator_type& random_bytes_generator() const { return random_bytes_generator_; }
+    inline generator_type& random_bytes_generator() { return random_bytes_generator_; }
+
+protected:
+    void generate_random_bytes_(std::span<uint8_t> bytes) final { random_bytes_generator_(bytes); }
+
+private:
+    generator_type random_bytes_generator_;
+};
+
+} // namespace cryp
+} // namespace arba
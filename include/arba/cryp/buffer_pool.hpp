@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Pool of reusable byte buffers, so that encrypting many messages does not allocate and free a buffer per message.
+// The buffers handed out can hold the encryption of their data without reallocation.
+// A pool is not thread-safe: use one pool per thread, like local(). A pool must outlive its borrowed buffers.
+class buffer_pool
+{
+public:
+    // Buffer borrowed from a pool. It is given back to the pool when destroyed.
+    class buffer
+    {
+    public:
+        buffer(buffer&& other) noexcept;
+        buffer& operator=(buffer&& other) noexcept;
+        ~buffer();
+
+        inline std::vector<uint8_t>& bytes() { return bytes_; }
+        inline const std::vector<uint8_t>& bytes() const { return bytes_; }
+        inline std::vector<uint8_t>& operator*() { return bytes_; }
+        inline const std::vector<uint8_t>& operator*() const { return bytes_; }
+        inline std::vector<uint8_t>* operator->() { return &bytes_; }
+        inline const std::vector<uint8_t>* operator->() const { return &bytes_; }
+
+    private:
+        friend class buffer_pool;
+        buffer(buffer_pool& pool, std::vector<uint8_t>&& bytes);
+
+    private:
+        buffer_pool* pool_;
+        std::vector<uint8_t> bytes_;
+    };
+
+    inline constexpr static std::size_t default_max_buffer_count = 16;
+
+    // At most max_buffer_count buffers are kept in the pool, the others are freed when given back.
+    explicit buffer_pool(std::size_t max_buffer_count = default_max_buffer_count);
+    buffer_pool(const buffer_pool&) = delete;
+    buffer_pool& operator=(const buffer_pool&) = delete;
+
+    // Returns an empty buffer whose capacity is at least symcrypt_base::encrypted_size(data_size).
+    // The smallest pooled buffer large enough is reused. A new buffer is allocated if there is none.
+    buffer acquire(std::size_t data_size);
+
+    // Number of buffers in the pool, waiting to be reused.
+    inline std::size_t size() const { return buffers_.size(); }
+    inline std::size_t max_buffer_count() const { return max_buffer_count_; }
+    // Frees the buffers of the pool.
+    void clear();
+
+    // Pool of the calling thread.
+    static buffer_pool& local();
+
+private:
+    void release_(std::vector<uint8_t>&& bytes) noexcept;
+
+private:
+    std::vector<std::vector<uint8_t>> buffers_;
+    std::size_t max_buffer_count_;
+};
+
+} // namespace cryp
+} // namespace arba
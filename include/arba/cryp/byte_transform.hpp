@@ -0,0 +1,86 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+// Instruction sets which can be used to transform byte sequences.
+enum class instruction_set : uint8_t
+{
+    scalar,
+    sse4,
+    avx2,
+    avx512,
+};
+
+std::string_view to_string_view(instruction_set iset);
+
+// Best instruction set supported by the running CPU (detected once).
+instruction_set best_instruction_set();
+bool instruction_set_is_supported(instruction_set iset);
+
+// Ways to transform byte sequences:
+// - arithmetic: the transform of each byte is computed, with the best instruction set,
+// - lookup_table: the rotations are read from tables (less than 5 KiB, built once per process), which may be faster on
+//   CPUs without fast popcount or variable rotate instructions.
+enum class byte_transform_mode : uint8_t
+{
+    arithmetic,
+    lookup_table,
+};
+
+std::string_view to_string_view(byte_transform_mode mode);
+
+// Mode used by the encrypt_bytes/decrypt_bytes overloads without instruction set, thus by symcrypt.
+// It is arithmetic, unless another one is set for the whole process.
+byte_transform_mode default_byte_transform_mode();
+void set_default_byte_transform_mode(byte_transform_mode mode);
+
+// encrypt/decrypt byte
+inline constexpr uint8_t encrypt_byte(uint8_t byte, uint8_t crypto_offset)
+{
+    uint8_t aux = byte + crypto_offset;                                       // Add an offset to the byte,
+    return std::rotl(aux, std::popcount(aux) * std::popcount(crypto_offset)); // bitwise left-rotate the byte.
+}
+
+inline constexpr uint8_t decrypt_byte(uint8_t byte, uint8_t crypto_offset)
+{
+    // bitwise right-rotate the byte and remove the offset.
+    return std::rotr(byte, std::popcount(byte) * std::popcount(crypto_offset)) - crypto_offset;
+}
+
+// encrypt/decrypt bytes
+// The i-th byte of input is transformed with crypto_offsets[i] and written to output[i].
+// input and output may be the same sequence.
+// The overloads without instruction set use default_byte_transform_mode(), and best_instruction_set() in arithmetic
+// mode. The ones with an instruction set use the best one if the requested one is not supported.
+void encrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size);
+void decrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size);
+void encrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size,
+                   instruction_set iset);
+void decrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size,
+                   instruction_set iset);
+void encrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size,
+                   byte_transform_mode mode);
+void decrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size,
+                   byte_transform_mode mode);
+
+// reencrypt bytes
+// The i-th byte of input is decrypted with old_crypto_offsets[i], encrypted again with new_crypto_offsets[i], and
+// written to output[i], in one pass. input and output may be the same sequence.
+// The overloads are chosen as for encrypt_bytes/decrypt_bytes.
+void reencrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* old_crypto_offsets,
+                     const uint8_t* new_crypto_offsets, std::size_t size);
+void reencrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* old_crypto_offsets,
+                     const uint8_t* new_crypto_offsets, std::size_t size, instruction_set iset);
+void reencrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* old_crypto_offsets,
+                     const uint8_t* new_crypto_offsets, std::size_t size, byte_transform_mode mode);
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Tells how an algorithm may split its work between several threads.
+class execution_policy
+{
+public:
+    enum class mode : uint8_t
+    {
+        sequential,
+        parallel,
+        automatic,
+    };
+
+    // Data smaller than this size are processed sequentially by automatic policies.
+    inline constexpr static std::size_t default_parallel_threshold = 1024 * 1024;
+
+    // A max thread count equal to 0 means that all the hardware threads can be used.
+    inline constexpr static execution_policy sequential() { return execution_policy(mode::sequential, 0, 1); }
+    inline constexpr static execution_policy parallel(std::size_t max_thread_count = 0)
+    {
+        return execution_policy(mode::parallel, 0, max_thread_count);
+    }
+    inline constexpr static execution_policy automatic(std::size_t parallel_threshold = default_parallel_threshold,
+                                                       std::size_t max_thread_count = 0)
+    {
+        return execution_policy(mode::automatic, parallel_threshold, max_thread_count);
+    }
+
+    // Compatibility with the former boolean flag: true is automatic(), false is sequential().
+    inline constexpr execution_policy(bool use_parallel_execution)
+        : execution_policy(use_parallel_execution ? automatic() : sequential())
+    {
+    }
+
+    inline constexpr mode execution_mode() const { return mode_; }
+    inline constexpr std::size_t parallel_threshold() const { return parallel_threshold_; }
+    inline constexpr std::size_t max_thread_count() const { return max_thread_count_; }
+
+    // Number of threads to use to process data_size bytes (1 means sequential execution).
+    std::size_t thread_count(std::size_t data_size) const;
+
+private:
+    inline constexpr execution_policy(mode execution_mode, std::size_t parallel_threshold,
+                                      std::size_t max_thread_count)
+        : parallel_threshold_(parallel_threshold), max_thread_count_(max_thread_count), mode_(execution_mode)
+    {
+    }
+
+private:
+    std::size_t parallel_threshold_;
+    std::size_t max_thread_count_;
+    mode mode_;
+};
+
+} // namespace cryp
+} // namespace arba
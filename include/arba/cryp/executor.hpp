@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Interface of the objects running the parallel tasks of arba-cryp algorithms.
+// Implement it to make arba-cryp use the thread pool of your application.
+class executor
+{
+public:
+    virtual ~executor() = default;
+
+    // Number of threads running tasks, without counting the thread calling bulk_execute().
+    virtual std::size_t concurrency() const = 0;
+
+    // Calls task(index) for each index in [0, task_count), and returns once all the calls are done.
+    // The calling thread may run some of the tasks. If a task throws, the first exception is rethrown.
+    virtual void bulk_execute(std::size_t task_count, const std::function<void(std::size_t)>& task) = 0;
+};
+
+// Executor running the tasks with std::execution::par when parallel_execution_is_available (with TBB),
+// sequentially otherwise.
+class std_parallel_executor : public executor
+{
+public:
+    std::size_t concurrency() const override;
+    void bulk_execute(std::size_t task_count, const std::function<void(std::size_t)>& task) override;
+};
+
+// Executor used by arba-cryp algorithms when no executor is given.
+// It is a process-wide thread_pool, unless another executor is set with set_default_executor().
+executor& default_executor();
+// The executor must outlive its use as default executor.
+void set_default_executor(executor& exec);
+
+} // namespace cryp
+} // namespace arba
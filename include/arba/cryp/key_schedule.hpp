@@ -0,0 +1,42 @@
+#pragma once
+
+#include <arba/cryp/keystream.hpp>
+
+#include <array>
+#include <cstdint>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Everything derived from a crypto key which does not depend on the encrypted message.
+// It is computed once when the key is set, instead of once per message.
+class key_schedule
+{
+public:
+    using crypto_key = std::array<uint8_t, keystream::key_size>;
+    using key_hash_bytes_array = std::array<uint8_t, keystream::offsets_size>;
+    using period_array = std::array<uint8_t, keystream::period>;
+
+    explicit key_schedule(const crypto_key& key);
+
+    // Bytes of the hash of key, without the rest of the key schedule.
+    static key_hash_bytes_array compute_key_hash_bytes(const crypto_key& key);
+
+    inline const crypto_key& key() const { return key_; }
+    // Bytes of the key hash, used to hide the offsets stored with the encrypted data.
+    inline const key_hash_bytes_array& key_hash_bytes() const { return key_hash_bytes_; }
+    // Part of the crypto offset of each byte of a keystream period which only depends on the key.
+    inline const period_array& key_offsets() const { return key_offsets_; }
+    // Index of the message offset added to the crypto offset of each byte of a keystream period.
+    inline const period_array& offset_indexes() const { return offset_indexes_; }
+
+private:
+    crypto_key key_;
+    key_hash_bytes_array key_hash_bytes_;
+    period_array key_offsets_;
+    period_array offset_indexes_;
+};
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <arba/cryp/basic_symcrypt.hpp>
+#include <arba/cryp/execution_policy.hpp>
+#include <arba/cryp/key_schedule.hpp>
+#include <arba/cryp/random_bytes.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Thread-safe map of key IDs (tenants, ...) to key schedules, computed once when a key is inserted.
+// Each update publishes an immutable snapshot of the map with a new generation number. Each thread caches weak
+// references to the last snapshots it read: while the map is not updated, a lookup takes no lock, it only loads the
+// generation and increments the reference count of the snapshot. The first lookup of a thread after an update takes a
+// shared lock to read the new snapshot. As the caches do not keep the snapshots alive, the key schedules of an erased
+// or replaced key, or of a destroyed keyring, are released once the lookup results and the encryptions in progress
+// which use them are done.
+// Updates copy the map, so they are meant to be rare.
+class keyring
+{
+public:
+    using crypto_key = key_schedule::crypto_key;
+    // symcrypt returned by symcrypt(key_id): it draws its random bytes with thread_local_random_bytes.
+    using symcrypt_type = basic_symcrypt<thread_local_random_bytes>;
+
+    keyring();
+    keyring(const keyring&) = delete;
+    keyring& operator=(const keyring&) = delete;
+
+    // Inserts the key of key_id, or replaces it.
+    // A password is turned into a crypto key as by symcrypt_base::to_crypto_key().
+    void insert_or_assign(std::string_view key_id, const crypto_key& key);
+    void insert_or_assign(std::string_view key_id, std::string_view password);
+    // Erases the key of key_id, and returns true if there was one.
+    bool erase(std::string_view key_id);
+
+    // Key schedule of key_id, or nullptr if there is none.
+    std::shared_ptr<const key_schedule> find(std::string_view key_id) const;
+    inline bool contains(std::string_view key_id) const { return find(key_id) != nullptr; }
+    std::size_t size() const;
+
+    // symcrypt using the key schedule of key_id.
+    // Throws std::out_of_range if there is no key for key_id.
+    symcrypt_type symcrypt(std::string_view key_id) const;
+
+    // Encryption/decryption with the key of key_id, as done by symcrypt_base.
+    // Throws std::out_of_range if there is no key for key_id.
+    void encrypt(std::string_view key_id, std::vector<uint8_t>& bytes,
+                 const execution_policy& policy = execution_policy::automatic()) const;
+    void decrypt(std::string_view key_id, std::vector<uint8_t>& bytes,
+                 const execution_policy& policy = execution_policy::automatic()) const;
+    std::size_t encrypt(std::string_view key_id, std::span<const std::byte> input, std::span<std::byte> output,
+                        const execution_policy& policy = execution_policy::automatic()) const;
+    std::size_t decrypt(std::string_view key_id, std::span<const std::byte> input, std::span<std::byte> output,
+                        const execution_policy& policy = execution_policy::automatic()) const;
+
+private:
+    using key_map = std::map<std::string, std::shared_ptr<const key_schedule>, std::less<>>;
+
+    // Current snapshot of the map, found in the cache of the calling thread if it is there.
+    std::shared_ptr<const key_map> snapshot_() const;
+    // Calls function with a symcrypt which does not own the key schedule of key_id: the snapshot keeps it alive
+    // during the call.
+    // Throws std::out_of_range if there is no key for key_id.
+    template <class SymcryptFunction>
+    auto with_symcrypt_(std::string_view key_id, SymcryptFunction function) const;
+    template <class UpdateFunction>
+    void update_(UpdateFunction update);
+
+private:
+    std::shared_ptr<const key_map> keys_;
+    // Generation of keys_, unique among all the keyrings.
+    std::atomic<uint64_t> generation_;
+    // Exclusive for the updates, shared for the reads of keys_.
+    mutable std::shared_mutex mutex_;
+};
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+inline namespace arba
+{
+namespace cryp
+{
+class key_schedule;
+
+// The sequence of crypto offsets used to encrypt/decrypt the bytes of a message.
+// The crypto offset of a byte only depends on the key, on the random offsets of the message and on the byte index.
+// This sequence is periodic, so it is computed once per message and then walked over the byte sequence.
+class keystream
+{
+public:
+    inline constexpr static std::size_t key_size = 16;
+    inline constexpr static std::size_t offsets_size = 8;
+    // Byte index modulo the key size, the offset index (where one offset is skipped every 9 bytes) modulo the number
+    // of offsets, and the byte index modulo 256, all repeat every 2304 bytes.
+    inline constexpr static std::size_t period = 2304;
+
+    using crypto_key_span = std::span<const uint8_t, key_size>;
+    using offsets_span = std::span<const uint8_t, offsets_size>;
+
+    // Only the min(length, period) first crypto offsets are computed.
+    keystream(crypto_key_span key, offsets_span offs, std::size_t length = period);
+    keystream(const key_schedule& schedule, offsets_span offs, std::size_t length = period);
+
+    // Crypto offset of one byte, computed without building the table.
+    inline constexpr static uint8_t crypto_offset(crypto_key_span key, offsets_span offs, std::size_t byte_index)
+    {
+        uint8_t key_byte = key[byte_index % key.size()];
+        std::size_t offset_index = key.back() + byte_index + (byte_index / (offs.size() + 1));
+        uint8_t offset = offs[offset_index % offs.size()]; // random start offset
+        offset += static_cast<uint8_t>(byte_index % 256);  // avoid repetition
+        offset += key_byte;
+        return offset;
+    }
+    static uint8_t crypto_offset(const key_schedule& schedule, offsets_span offs, std::size_t byte_index);
+
+    // Encrypts/decrypts size bytes of a message, the first one being the byte first_index of the message.
+    // The keystream must cover the indexes [first_index, first_index + size), unless size() == period.
+    // input and output may be the same sequence.
+    void encrypt(const uint8_t* input, uint8_t* output, std::size_t size, std::size_t first_index = 0) const;
+    void decrypt(const uint8_t* input, uint8_t* output, std::size_t size, std::size_t first_index = 0) const;
+    // Decrypts size bytes with this keystream and encrypts them again with new_keystream, in one pass.
+    // Both keystreams must cover the indexes [first_index, first_index + size), unless their size() == period.
+    void reencrypt(const keystream& new_keystream, const uint8_t* input, uint8_t* output, std::size_t size,
+                   std::size_t first_index = 0) const;
+
+    inline std::size_t size() const { return size_; }
+    inline const uint8_t* data() const { return table_.data(); }
+    // The byte index must be lower than size(), unless size() == period.
+    inline uint8_t operator[](std::size_t byte_index) const { return table_[byte_index % period]; }
+
+private:
+    std::array<uint8_t, period> table_;
+    std::size_t size_;
+};
+
+} // namespace cryp
+} // namespace arba
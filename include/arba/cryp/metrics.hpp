@@ -0,0 +1,125 @@
+#pragma once
+
+#include <arba/cryp/config.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Instrumentation of the symcrypt algorithms, enabled with the CMake option ARBA_CRYP_INSTRUMENTATION.
+// When it is disabled, the hooks are compiled out and the sink is never called.
+
+enum class metric_counter : uint8_t
+{
+    encrypt_calls,
+    decrypt_calls,
+    encrypted_bytes,
+    decrypted_bytes,
+    random_bytes_calls,
+    random_bytes,
+    reallocations,
+    sequential_dispatches,
+    parallel_dispatches,
+    parallel_tasks,
+};
+inline constexpr std::size_t metric_counter_count = static_cast<std::size_t>(metric_counter::parallel_tasks) + 1;
+
+enum class metric_phase : uint8_t
+{
+    random_bytes_generation,
+    keystream_construction,
+    transform,
+};
+inline constexpr std::size_t metric_phase_count = static_cast<std::size_t>(metric_phase::transform) + 1;
+
+std::string_view to_string_view(metric_counter counter);
+std::string_view to_string_view(metric_phase phase);
+
+// Receives the metrics. It may be called concurrently by several threads.
+class metrics_sink
+{
+public:
+    virtual ~metrics_sink() = default;
+    virtual void add(metric_counter counter, uint64_t value) = 0;
+    virtual void record(metric_phase phase, std::chrono::nanoseconds duration) = 0;
+};
+
+// Sink receiving the metrics of the whole process (none by default). It must outlive its use.
+metrics_sink* current_metrics_sink();
+void set_metrics_sink(metrics_sink* sink);
+
+// Sink storing the counters, and a histogram of the durations of each phase.
+class histogram_metrics_sink final : public metrics_sink
+{
+public:
+    // The bucket i counts the durations in [2^i, 2^(i+1)) ns, the last one counts the longer ones.
+    inline constexpr static std::size_t bucket_count = 40;
+    using histogram = std::array<uint64_t, bucket_count>;
+
+    void add(metric_counter counter, uint64_t value) override;
+    void record(metric_phase phase, std::chrono::nanoseconds duration) override;
+
+    uint64_t counter(metric_counter counter) const;
+    histogram phase_histogram(metric_phase phase) const;
+    void reset();
+
+private:
+    std::array<std::atomic<uint64_t>, metric_counter_count> counters_{};
+    std::array<std::array<std::atomic<uint64_t>, bucket_count>, metric_phase_count> histograms_{};
+};
+
+// Hooks, used by the algorithms.
+
+inline void add_metric(metric_counter counter, uint64_t value = 1)
+{
+    if constexpr (instrumentation_is_enabled)
+    {
+        if (metrics_sink* sink = current_metrics_sink())
+            sink->add(counter, value);
+    }
+}
+
+// Records the duration of its scope.
+class scoped_phase_timer
+{
+public:
+    explicit scoped_phase_timer(metric_phase phase)
+    {
+        if constexpr (instrumentation_is_enabled)
+        {
+            sink_ = current_metrics_sink();
+            if (sink_)
+            {
+                phase_ = phase;
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+    }
+
+    scoped_phase_timer(const scoped_phase_timer&) = delete;
+    scoped_phase_timer& operator=(const scoped_phase_timer&) = delete;
+
+    ~scoped_phase_timer()
+    {
+        if constexpr (instrumentation_is_enabled)
+        {
+            if (sink_)
+                sink_->record(phase_, std::chrono::steady_clock::now() - start_);
+        }
+    }
+
+private:
+    metrics_sink* sink_ = nullptr;
+    metric_phase phase_ = metric_phase::transform;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace cryp
+} // namespace arba
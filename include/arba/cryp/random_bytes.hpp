@@ -0,0 +1,26 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Generator filling a sequence of bytes with random values in one call.
+template <class generator_type>
+concept random_bytes_generator = std::invocable<generator_type&, std::span<uint8_t>>;
+
+using random_bytes_function = std::function<void(std::span<uint8_t>)>;
+
+// Random bytes drawn from a buffer owned by the calling thread.
+// The buffer is refilled with 64-bit draws of a thread-local engine whose whole state is seeded by std::random_device.
+struct thread_local_random_bytes
+{
+    void operator()(std::span<uint8_t> bytes) const;
+};
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <arba/cryp/execution_policy.hpp>
+#include <arba/cryp/symcrypt_base.hpp>
+#include <arba/cryp/symcrypt_pipeline.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Container of many small encrypted records, with the records grouped into segments.
+// Each segment is encrypted as one message, so the trailer and the padding of an encryption are paid once per
+// segment, and the records of a segment share its random offsets. A record only costs 4 bytes of index.
+//
+// Container layout: [ magic | segment 0 | ... | segment n-1 | segment ends | records per segment | record count |
+// magic ]. A segment is the encryption of [ record 0 | ... | record m-1 | record ends ], where the record ends are
+// the 32-bit offsets of the ends of the records in the segment. The other integers are 64-bit, and all are stored in
+// little-endian order.
+struct record_container_format
+{
+    inline constexpr static std::array<std::byte, 8> magic{ std::byte('a'), std::byte('c'), std::byte('r'),
+                                                            std::byte('y'), std::byte('p'), std::byte('r'),
+                                                            std::byte('c'), std::byte('1') };
+    inline constexpr static std::size_t record_end_size = sizeof(uint32_t);
+    // Size of the end of the container, after the segment ends.
+    inline constexpr static std::size_t footer_size = 2 * sizeof(uint64_t) + magic.size();
+};
+
+// Appends records to a record container, written into a sink segment by segment.
+class record_writer
+{
+public:
+    inline constexpr static std::size_t default_records_per_segment = 1024;
+
+    // The symcrypt must outlive the writer.
+    // Throws std::invalid_argument if records_per_segment is 0.
+    record_writer(symcrypt_base& symcrypt, chunk_sink sink,
+                  std::size_t records_per_segment = default_records_per_segment,
+                  const execution_policy& policy = execution_policy::automatic());
+
+    inline std::size_t records_per_segment() const { return records_per_segment_; }
+    inline std::size_t record_count() const { return record_count_; }
+
+    // Appends a record, and returns its index. The segment is encrypted and written once it is full.
+    // Throws std::logic_error if the container is finished,
+    // or std::length_error if the segment would exceed 4 GiB.
+    std::size_t append(std::span<const std::byte> record);
+    // Writes the last segment and the end of the container. It must be called once all the records are appended.
+    // Throws std::logic_error if the container is already finished.
+    void finish();
+    inline bool is_finished() const { return is_finished_; }
+
+private:
+    void write_segment_();
+
+private:
+    symcrypt_base* symcrypt_;
+    chunk_sink sink_;
+    std::size_t records_per_segment_;
+    execution_policy policy_;
+    std::size_t record_count_ = 0;
+    std::vector<uint8_t> segment_;
+    std::vector<uint32_t> record_ends_;
+    std::vector<uint64_t> segment_ends_;
+    bool is_finished_ = false;
+};
+
+// Reads the records of a record container stored in memory (a memory-mapped file, ...).
+// A record is found in constant time: only its index entries and its bytes are decrypted.
+// The reader is thread-safe.
+class record_reader
+{
+public:
+    // Called for each record by for_each_record().
+    using record_function = std::function<void(std::size_t record_index, std::span<const std::byte> record)>;
+
+    // The container must outlive the reader, not the symcrypt.
+    // Throws std::invalid_argument if container is not a record container.
+    record_reader(const symcrypt_base& symcrypt, std::span<const std::byte> container);
+
+    inline std::size_t record_count() const { return record_count_; }
+    inline std::size_t records_per_segment() const { return records_per_segment_; }
+    inline std::size_t segment_count() const { return segment_ends_.size(); }
+
+    // Size of a record.
+    // Throws std::out_of_range if record_index is not lower than record_count(),
+    // or std::invalid_argument if the segment of the record is corrupted or encrypted with another key.
+    std::size_t record_size(std::size_t record_index) const;
+    // Decrypts a record into output, and returns its size.
+    // Throws as record_size(), or std::invalid_argument if output is too small.
+    std::size_t read_record(std::size_t record_index, std::span<std::byte> output) const;
+    std::vector<std::byte> record(std::size_t record_index) const;
+
+    // Decrypts the whole segments, and calls function for each record. The segments are spread over the threads of
+    // the executor of the symcrypt (the policy applies to the total size of the segments): function is called in
+    // order for the records of a segment, but may be called concurrently for records of different segments.
+    // Throws std::invalid_argument if a segment is corrupted or encrypted with another key.
+    void for_each_record(const record_function& function,
+                         const execution_policy& policy = execution_policy::automatic()) const;
+
+private:
+    struct record_location
+    {
+        std::size_t segment_index;
+        std::size_t first_record_index;
+        std::size_t record_count;
+    };
+
+    record_location locate_(std::size_t record_index) const;
+    // Returns function(lookup, offset, size), where lookup decrypts the bytes of the segment of the record, and
+    // offset and size locate the record in its segment.
+    template <class RecordFunction>
+    auto visit_record_(std::size_t record_index, RecordFunction function) const;
+    std::span<const std::byte> segment_bytes_(std::size_t segment_index) const;
+
+private:
+    const symcrypt_base* symcrypt_;
+    std::span<const std::byte> container_;
+    std::size_t records_per_segment_;
+    std::size_t record_count_;
+    std::vector<std::size_t> segment_ends_;
+};
+
+} // namespace cryp
+} // namespace arba
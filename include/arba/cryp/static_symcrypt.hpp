@@ -0,0 +1,142 @@
+#pragma once
+
+#include <arba/cryp/byte_transform.hpp>
+#include <arba/cryp/key_schedule.hpp>
+#include <arba/cryp/keystream.hpp>
+#include <arba/cryp/random_bytes.hpp>
+#include <arba/cryp/symcrypt_base.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+inline namespace arba
+{
+namespace cryp
+{
+// symcrypt for messages whose size is known at compile time, with the format of symcrypt_base::encrypt().
+// The layout of the encrypted message is computed at compile time, nothing is allocated, and the byte transform of
+// small messages is unrolled. Everything is constexpr: constants can be encrypted at compile time, given the random
+// bytes.
+template <std::size_t DataSize>
+class static_symcrypt
+{
+public:
+    using crypto_key = symcrypt_base::crypto_key;
+    using key_hash_bytes_array = key_schedule::key_hash_bytes_array;
+
+    inline constexpr static std::size_t data_size = DataSize;
+    inline constexpr static std::size_t padding_size =
+        data_size < symcrypt_base::min_data_size ? symcrypt_base::min_data_size - data_size : 0;
+    // The random bytes are the padding bytes followed by the offsets.
+    inline constexpr static std::size_t random_bytes_size = padding_size + keystream::offsets_size;
+    inline constexpr static std::size_t encrypted_size = symcrypt_base::encrypted_size(data_size);
+    // Messages up to this size (padding and size byte included) are transformed byte by byte, with unrolled code.
+    // Bigger ones use the vectorized byte transform at runtime.
+    inline constexpr static std::size_t unrolled_size_limit = 64;
+
+    using data_array = std::array<uint8_t, data_size>;
+    using random_bytes_array = std::array<uint8_t, random_bytes_size>;
+    using encrypted_array = std::array<uint8_t, encrypted_size>;
+
+    // key_hash_bytes must be key_schedule::compute_key_hash_bytes(key), which cannot be computed at compile time.
+    constexpr static_symcrypt(const crypto_key& key, const key_hash_bytes_array& key_hash_bytes)
+        : key_(key), key_hash_bytes_(key_hash_bytes)
+    {
+    }
+
+    explicit static_symcrypt(const crypto_key& key)
+        : static_symcrypt(key, key_schedule::compute_key_hash_bytes(key))
+    {
+    }
+
+    inline constexpr const crypto_key& key() const { return key_; }
+    inline constexpr const key_hash_bytes_array& key_hash_bytes() const { return key_hash_bytes_; }
+
+    constexpr encrypted_array encrypt(const data_array& data, const random_bytes_array& random_bytes) const
+    {
+        offsets_array offs;
+        for (std::size_t i = 0; i < offs.size(); ++i)
+            offs[i] = random_bytes[padding_size + i];
+
+        // The data are padded, and size information is stored at the end of data.
+        encrypted_array output{};
+        for (std::size_t i = 0; i < data_size; ++i)
+            output[i] = data[i];
+        for (std::size_t i = 0; i < padding_size; ++i)
+            output[data_size + i] = random_bytes[i];
+        output[body_size - 1] = size_byte;
+        transform_<body_size, true>(offs, output.data(), output.data());
+        // The offsets are appended, hidden with the key hash.
+        for (std::size_t i = 0; i < offs.size(); ++i)
+            output[body_size + i] = offs[i] + key_hash_bytes_[i];
+        return output;
+    }
+
+    template <random_bytes_generator GeneratorType>
+    encrypted_array encrypt(const data_array& data, GeneratorType&& rng) const
+    {
+        random_bytes_array random_bytes;
+        rng(std::span<uint8_t>(random_bytes));
+        return encrypt(data, random_bytes);
+    }
+
+    encrypted_array encrypt(const data_array& data) const { return encrypt(data, thread_local_random_bytes()); }
+
+    // The size byte is not read: the size of the data is known.
+    constexpr data_array decrypt(const encrypted_array& encrypted_data) const
+    {
+        offsets_array offs;
+        for (std::size_t i = 0; i < offs.size(); ++i)
+            offs[i] = encrypted_data[body_size + i] - key_hash_bytes_[i];
+
+        data_array output{};
+        transform_<data_size, false>(offs, encrypted_data.data(), output.data());
+        return output;
+    }
+
+private:
+    using offsets_array = std::array<uint8_t, keystream::offsets_size>;
+
+    inline constexpr static std::size_t body_size = encrypted_size - keystream::offsets_size;
+    inline constexpr static uint8_t size_byte =
+        data_size <= symcrypt_base::min_data_size ? data_size : symcrypt_base::min_data_size + 1;
+
+    template <std::size_t Size, bool IsEncryption>
+    constexpr void transform_(const offsets_array& offs, const uint8_t* input, uint8_t* output) const
+    {
+        constexpr auto transform_byte = IsEncryption ? &encrypt_byte : &decrypt_byte;
+        if constexpr (Size <= unrolled_size_limit)
+        {
+            // The crypto offset of each byte is computed with a constant byte index.
+            [&]<std::size_t... Indexes>(std::index_sequence<Indexes...>)
+            {
+                ((output[Indexes] = transform_byte(input[Indexes], keystream::crypto_offset(key_, offs, Indexes))),
+                 ...);
+            }(std::make_index_sequence<Size>{});
+        }
+        else if (std::is_constant_evaluated())
+        {
+            for (std::size_t i = 0; i < Size; ++i)
+                output[i] = transform_byte(input[i], keystream::crypto_offset(key_, offs, i));
+        }
+        else
+        {
+            const keystream kstream(key_, offs, Size);
+            if constexpr (IsEncryption)
+                kstream.encrypt(input, output, Size);
+            else
+                kstream.decrypt(input, output, Size);
+        }
+    }
+
+private:
+    crypto_key key_;
+    key_hash_bytes_array key_hash_bytes_;
+};
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <arba/cryp/execution_policy.hpp>
+#include <arba/cryp/executor.hpp>
+#include <arba/cryp/key_schedule.hpp>
+#include <arba/cryp/keystream.hpp>
+#include <arba/cryp/metrics.hpp>
+
+#include <arba/uuid/uuid.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Symmetric encryption algorithm, whatever the source of random bytes.
+// The derived classes provide the random bytes used to pad small data and to offset the keystream.
+//
+// Encrypted data layout: [ data | random padding up to min_data_size | size byte | 8 offsets ].
+// Data, padding and size byte are encrypted with the keystream. The offsets are hidden with the key hash.
+class symcrypt_base
+{
+public:
+    inline constexpr static uint8_t min_data_size = sizeof(uuid::uuid);
+    using crypto_key = std::array<uint8_t, min_data_size>;
+    static_assert(std::is_same_v<crypto_key, key_schedule::crypto_key>);
+    // Size byte of the data larger than min_data_size.
+    inline constexpr static uint8_t min_data_size_1 = min_data_size + 1;
+    static_assert(min_data_size_1 > min_data_size);
+
+protected:
+    static_assert(min_data_size == keystream::key_size);
+    using offsets = std::array<uint8_t, keystream::offsets_size>;
+
+public:
+    // Size of the trailer appended to the encrypted data: the size byte and the offsets.
+    inline constexpr static std::size_t trailer_size = 1 + keystream::offsets_size;
+    // Size of the encryption of the smallest data.
+    inline constexpr static std::size_t min_encrypted_size = min_data_size + trailer_size;
+
+    virtual ~symcrypt_base() = default;
+
+    void encrypt(std::vector<uint8_t>& bytes, const execution_policy& policy = execution_policy::automatic());
+    void decrypt(std::vector<uint8_t>& bytes, const execution_policy& policy = execution_policy::automatic());
+    // Overloads for vectors with another allocator (std::pmr::vector<uint8_t>, ...).
+    // The vector grows at most once, and not at all if its capacity is at least encrypted_size(bytes.size()).
+    template <class Allocator>
+    void encrypt(std::vector<uint8_t, Allocator>& bytes,
+                 const execution_policy& policy = execution_policy::automatic());
+    template <class Allocator>
+    void decrypt(std::vector<uint8_t, Allocator>& bytes,
+                 const execution_policy& policy = execution_policy::automatic());
+
+    // Size of the encryption of data_size bytes.
+    inline constexpr static std::size_t encrypted_size(std::size_t data_size)
+    {
+        return std::max<std::size_t>(data_size, min_data_size) + trailer_size;
+    }
+    // Size of the decryption of encrypted_bytes.
+    // Throws std::invalid_argument if encrypted_bytes is smaller than min_encrypted_size.
+    std::size_t decrypted_size(std::span<const std::byte> encrypted_bytes) const;
+
+    // Encrypts input into output, and returns encrypted_size(input.size()).
+    // Throws std::invalid_argument if output is too small.
+    std::size_t encrypt(std::span<const std::byte> input, std::span<std::byte> output,
+                        const execution_policy& policy = execution_policy::automatic());
+    // Decrypts input into output, and returns decrypted_size(input).
+    // Throws std::invalid_argument if input or output is too small.
+    std::size_t decrypt(std::span<const std::byte> input, std::span<std::byte> output,
+                        const execution_policy& policy = execution_policy::automatic());
+
+    // Encrypts the data_size first bytes of buffer in place, and returns encrypted_size(data_size).
+    // Throws std::invalid_argument if buffer is smaller than encrypted_size(data_size).
+    std::size_t encrypt_in_place(std::span<std::byte> buffer, std::size_t data_size,
+                                 const execution_policy& policy = execution_policy::automatic());
+    // Decrypts the encrypted bytes of buffer in place, and returns the size of the decrypted data,
+    // stored at the beginning of buffer.
+    // Throws std::invalid_argument if buffer is smaller than min_encrypted_size.
+    std::size_t decrypt_in_place(std::span<std::byte> buffer,
+                                 const execution_policy& policy = execution_policy::automatic());
+
+    // Checked API: the encrypted message also holds checksums of the data, computed in the same pass as the
+    // encryption and verified in the same pass as the decryption.
+    // Encrypted data layout: [ data | checksums | random padding | size byte | 8 offsets ], the checksums being
+    // encrypted with the data. They are not a MAC: they detect corrupted or truncated data, not forged data.
+    inline constexpr static std::size_t checksum_size = sizeof(uint64_t);
+    // The data have one checksum per block of checksum_block_size bytes, the last one being shorter (empty data have
+    // the checksum of an empty block): the 64-bit murmur hash of the block, stored in little-endian. This is part of
+    // the format: changing it breaks the data encrypted before.
+    inline constexpr static std::size_t checksum_block_size = 28 * keystream::period;
+    // Number of checksums of data_size bytes.
+    inline constexpr static std::size_t checksum_count(std::size_t data_size)
+    {
+        return std::max<std::size_t>((data_size + checksum_block_size - 1) / checksum_block_size, 1);
+    }
+    // Size of the checked encryption of data_size bytes.
+    inline constexpr static std::size_t checked_encrypted_size(std::size_t data_size)
+    {
+        return encrypted_size(data_size + checksum_count(data_size) * checksum_size);
+    }
+    // Encrypts input into output with its checksums, and returns checked_encrypted_size(input.size()).
+    // input and output may be the same sequence.
+    // Throws std::invalid_argument if output is too small.
+    std::size_t encrypt_checked(std::span<const std::byte> input, std::span<std::byte> output,
+                                const execution_policy& policy = execution_policy::automatic());
+    // Decrypts input, encrypted by encrypt_checked(), into output, verifies the checksums, and returns the size of the
+    // decrypted data. input and output may be the same sequence.
+    // Each block is verified as soon as it is decrypted, and the decryption stops at the first mismatch. Then, output
+    // does not keep the unverified data: if input and output are the same sequence, input is restored, else output
+    // is zeroed.
+    // Throws std::invalid_argument if input or output is too small, if input has no checksums, or if a checksum does
+    // not match.
+    std::size_t decrypt_checked(std::span<const std::byte> input, std::span<std::byte> output,
+                                const execution_policy& policy = execution_policy::automatic());
+    void encrypt_checked(std::vector<uint8_t>& bytes, const execution_policy& policy = execution_policy::automatic());
+    void decrypt_checked(std::vector<uint8_t>& bytes, const execution_policy& policy = execution_policy::automatic());
+
+    // Key rotation: re-encrypts in place data encrypted with the old key, so that they are encrypted with the key of
+    // this symcrypt. The data are decrypted and encrypted again in one pass, and the size is unchanged.
+    // Throws std::invalid_argument if encrypted_bytes is smaller than min_encrypted_size.
+    void reencrypt(const key_schedule& old_schedule, std::span<std::byte> encrypted_bytes,
+                   const execution_policy& policy = execution_policy::automatic());
+    void reencrypt(const crypto_key& old_key, std::span<std::byte> encrypted_bytes,
+                   const execution_policy& policy = execution_policy::automatic());
+    void reencrypt(const crypto_key& old_key, std::vector<uint8_t>& bytes,
+                   const execution_policy& policy = execution_policy::automatic());
+
+    // Scatter-gather API, for messages made of several fragments (header and body segments, ...), which do not have
+    // to be concatenated.
+    // Size of the trailer of the encryption of data_size bytes: the padding, the size byte and the offsets.
+    inline constexpr static std::size_t scattered_trailer_size(std::size_t data_size)
+    {
+        return encrypted_size(data_size) - data_size;
+    }
+    // Encrypts the fragments in place, as one message made of their concatenation, writes the end of the encrypted
+    // message into trailer, and returns scattered_trailer_size() of the data size.
+    // The encrypted message is the concatenation of the fragments and of the trailer.
+    // Throws std::invalid_argument if trailer is too small.
+    std::size_t encrypt_scattered(std::span<const std::span<std::byte>> fragments, std::span<std::byte> trailer,
+                                  const execution_policy& policy = execution_policy::automatic());
+    // Decrypts in place the encrypted message made of the concatenation of the fragments, and returns the size of the
+    // decrypted data, stored at the beginning of the fragments.
+    // Throws std::invalid_argument if the fragments are smaller than min_encrypted_size.
+    std::size_t decrypt_scattered(std::span<const std::span<std::byte>> fragments,
+                                  const execution_policy& policy = execution_policy::automatic());
+
+    // Batch API, for many small messages: the random bytes of the whole batch are generated in one call, and the
+    // messages are spread over the threads (the policy applies to the total size of the batch).
+    // Size of the encryption of the messages: the sum of their encrypted_size().
+    static std::size_t encrypted_batch_size(std::span<const std::span<const std::byte>> messages);
+    // Size of the decryption of the encrypted messages: the sum of their decrypted_size().
+    // Throws std::invalid_argument if an encrypted message is smaller than min_encrypted_size.
+    std::size_t decrypted_batch_size(std::span<const std::span<const std::byte>> encrypted_messages) const;
+    // Encrypts the messages into output, one after the other, and returns encrypted_batch_size(messages).
+    // Throws std::invalid_argument if output is too small.
+    std::size_t encrypt_batch(std::span<const std::span<const std::byte>> messages, std::span<std::byte> output,
+                              const execution_policy& policy = execution_policy::automatic());
+    // Decrypts the encrypted messages into output, one after the other, and returns the total size of the decrypted
+    // messages. The size of each decrypted message is stored in message_sizes.
+    // Throws std::invalid_argument if an encrypted message is smaller than min_encrypted_size, or if output or
+    // message_sizes is too small.
+    std::size_t decrypt_batch(std::span<const std::span<const std::byte>> encrypted_messages,
+                              std::span<std::byte> output, std::span<std::size_t> message_sizes,
+                              const execution_policy& policy = execution_policy::automatic());
+
+    // Encryption with random bytes drawn beforehand: the random bytes generator is not meant to be called by several
+    // threads at once, but the encryptions using random bytes already drawn can run concurrently, or by parts.
+    // Fills bytes with random values, as for the padding bytes and the offsets of an encryption.
+    void draw_random_bytes(std::span<uint8_t> bytes);
+    // Random bytes used to encrypt some data: the padding bytes (min_data_size - data_size bytes, if data_size is
+    // lower than min_data_size), then the keystream::offsets_size offsets.
+    using random_bytes_array = std::array<uint8_t, keystream::offsets_size + min_data_size>;
+    // Draws the random bytes used to encrypt data_size bytes.
+    random_bytes_array draw_random_bytes(std::size_t data_size);
+    // Encrypts input into output as encrypt() does, with random bytes drawn by draw_random_bytes(input.size()), and
+    // returns encrypted_size(input.size()).
+    // Throws std::invalid_argument if output is too small.
+    std::size_t encrypt(std::span<const std::byte> input, std::span<std::byte> output,
+                        const random_bytes_array& random_bytes,
+                        const execution_policy& policy = execution_policy::automatic()) const;
+    // Writes the end of the encryption of data_size bytes with random_bytes (its scattered_trailer_size(data_size)
+    // bytes after the data) into trailer, and returns the keystream encrypting the data.
+    // Throws std::invalid_argument if trailer is too small.
+    keystream encrypt_trailer(std::size_t data_size, const random_bytes_array& random_bytes,
+                              std::span<std::byte> trailer) const;
+
+    // Decryption by parts: the offsets and the data size are retrieved from the trailer of the ciphertext.
+    // Offsets of a message, retrieved from the encrypted offsets ending its ciphertext with the key hash of schedule.
+    static std::array<uint8_t, keystream::offsets_size>
+    retrieve_offsets(const key_schedule& schedule,
+                     std::span<const std::byte, keystream::offsets_size> encrypted_offsets);
+    // Size of the data of a ciphertext of encrypted_size bytes (at least min_encrypted_size), from its encrypted size
+    // byte and its offsets, retrieved by retrieve_offsets() with the key hash of schedule.
+    static std::size_t decrypted_size(const key_schedule& schedule, keystream::offsets_span offs,
+                                      std::byte encrypted_size_byte, std::size_t encrypted_size);
+
+    inline const crypto_key& key() const { return key_schedule_->key(); }
+    void set_key(const crypto_key& key);
+    [[deprecated]] inline void set_key(const uuid::uuid& key) { set_key(crypto_key(key.data())); }
+    void set_key(const std::string_view& key);
+
+    // The key schedule is shared by the copies of this symcrypt, until their key is changed.
+    inline const std::shared_ptr<const key_schedule>& shared_key_schedule() const { return key_schedule_; }
+    // Uses a key schedule computed beforehand (by a keyring, ...).
+    // Throws std::invalid_argument if schedule is null.
+    void set_key_schedule(std::shared_ptr<const key_schedule> schedule);
+
+    // Crypto key derived from a password, as done by the constructor and by set_key() taking a string.
+    static crypto_key to_crypto_key(const std::string_view& key);
+
+    // Executor running the parallel tasks. default_executor() is used unless another one is set.
+    inline cryp::executor& parallel_executor() const { return executor_ ? *executor_ : default_executor(); }
+    // The executor must outlive its use by this symcrypt.
+    inline void set_parallel_executor(cryp::executor& exec) { executor_ = &exec; }
+
+protected:
+    explicit symcrypt_base(const crypto_key& key);
+    explicit symcrypt_base(const std::string_view& key);
+    explicit symcrypt_base(std::shared_ptr<const key_schedule> schedule);
+    symcrypt_base(const symcrypt_base&) = default;
+    symcrypt_base(symcrypt_base&&) = default;
+    symcrypt_base& operator=(const symcrypt_base&) = default;
+    symcrypt_base& operator=(symcrypt_base&&) = default;
+
+    // Fills bytes with random values. It is called once per encryption, for the padding bytes and the offsets.
+    virtual void generate_random_bytes_(std::span<uint8_t> bytes) = 0;
+
+private:
+    // encrypt/decrypt data
+    // input and output may be the same sequence.
+    void encrypt_(const uint8_t* input, std::size_t data_size, uint8_t* output, const execution_policy& policy);
+    // random_bytes holds the random_bytes_size_(data_size) bytes used by the encryption.
+    void encrypt_(const uint8_t* input, std::size_t data_size, uint8_t* output, const uint8_t* random_bytes,
+                  const execution_policy& policy) const;
+    std::size_t decrypt_(const uint8_t* input, std::size_t encrypted_size, uint8_t* output,
+                         const execution_policy& policy);
+
+    // Writes the encrypted padding, size byte and offsets of a message of data_size bytes at tail.
+    void encrypt_trailer_(uint8_t* tail, std::size_t data_size, const uint8_t* random_bytes, const offsets& offs,
+                          const keystream& kstream) const;
+
+    // add/remove data size
+    // Number of random bytes used to encrypt data_size bytes: the padding and the offsets.
+    inline constexpr static std::size_t random_bytes_size_(std::size_t data_size)
+    {
+        return (data_size < min_data_size ? min_data_size - data_size : 0) + keystream::offsets_size;
+    }
+    static std::size_t decrypted_size_(std::size_t encrypted_size, uint8_t size_byte);
+    // Offsets drawn in the random bytes used to encrypt data_size bytes (after the padding bytes).
+    static offsets random_offsets_(const uint8_t* random_bytes, std::size_t data_size);
+
+    // encrypt/decrypt offsets
+    void encrypt_and_stores_offsets_(uint8_t* output, const offsets& offs) const;
+    // The offsets are hidden with the key hash of schedule.
+    static void decrypt_and_retrieves_offsets_(const key_schedule& schedule, const uint8_t* input, offsets& offs);
+
+    // encrypt/decrypt bytes
+    // The first byte of input is the byte first_index of the message.
+    void encrypt_seq_(const uint8_t* input, uint8_t* output, std::size_t size, const keystream& kstream,
+                      const execution_policy& policy, std::size_t first_index = 0) const;
+    void decrypt_seq_(const uint8_t* input, uint8_t* output, std::size_t size, const keystream& kstream,
+                      const execution_policy& policy, std::size_t first_index = 0) const;
+
+private:
+    std::shared_ptr<const key_schedule> key_schedule_;
+    cryp::executor* executor_ = nullptr;
+};
+
+template <class Allocator>
+void symcrypt_base::encrypt(std::vector<uint8_t, Allocator>& bytes, const execution_policy& policy)
+{
+    // The vector grows once, to hold the padding and the trailer.
+    const std::size_t data_size = bytes.size();
+    if (bytes.capacity() < encrypted_size(data_size))
+        add_metric(metric_counter::reallocations);
+    bytes.resize(encrypted_size(data_size));
+    encrypt_(bytes.data(), data_size, bytes.data(), policy);
+}
+
+template <class Allocator>
+void symcrypt_base::decrypt(std::vector<uint8_t, Allocator>& bytes, const execution_policy& policy)
+{
+    bytes.resize(decrypt_in_place(std::as_writable_bytes(std::span(bytes)), policy));
+}
+
+} // namespace cryp
+} // namespace arba
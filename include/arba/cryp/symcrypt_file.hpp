@@ -0,0 +1,133 @@
+#pragma once
+
+#include <arba/cryp/execution_policy.hpp>
+#include <arba/cryp/symcrypt_base.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Encrypts/decrypts a whole file into another one, with the format of symcrypt_base::encrypt().
+// On POSIX systems, both files are memory-mapped, so the data are neither copied into a buffer nor read twice.
+// The output file is created or truncated. It is removed if the encryption/decryption fails after that.
+// Returns the size of the output file.
+// Throws std::filesystem::filesystem_error if a file cannot be opened, mapped or resized,
+// and std::invalid_argument if both paths are the same file, or if the input file is not an encrypted file.
+std::size_t encrypt_file(symcrypt_base& symcrypt, const std::filesystem::path& input_path,
+                         const std::filesystem::path& output_path,
+                         const execution_policy& policy = execution_policy::automatic());
+std::size_t decrypt_file(symcrypt_base& symcrypt, const std::filesystem::path& input_path,
+                         const std::filesystem::path& output_path,
+                         const execution_policy& policy = execution_policy::automatic());
+
+// Backend of encrypt_file_async()/decrypt_file_async().
+enum class file_io_backend : uint8_t
+{
+    // io_uring if it is available, threads otherwise.
+    automatic,
+    // Linux io_uring: the reads and writes are queued in the kernel, without a thread per request.
+    io_uring,
+    // Threads calling pread()/pwrite().
+    threads,
+};
+
+// True if backend can be used on this system. automatic and threads are always available.
+bool file_io_backend_is_available(file_io_backend backend);
+
+struct async_file_options
+{
+    inline constexpr static std::size_t default_chunk_size = 1024 * 1024;
+
+    // Size of the chunks read from the input file.
+    std::size_t chunk_size = default_chunk_size;
+    // Number of chunk buffers, which is also the maximum number of reads and writes in flight (at most 1024).
+    // 0 means twice the number of threads of the executor, plus 2.
+    std::size_t buffer_count = 0;
+    file_io_backend backend = file_io_backend::automatic;
+};
+
+// Encrypts/decrypts a whole file into another one, as encrypt_file()/decrypt_file() do, with asynchronous reads and
+// writes: the files are not mapped, but read and written by chunks through a queue of in-flight requests. The chunks
+// read so far are encrypted/decrypted with the executor of the symcrypt (as allowed by the policy) while the other
+// requests are processed, and a chunk is written as soon as it is transformed. The memory used is bounded by
+// buffer_count * chunk_size, whatever the size of the files. With io_uring, the buffers are registered once.
+// On systems without pread()/pwrite() (Windows), they are encrypt_file()/decrypt_file().
+// Returns the size of the output file.
+// Throws std::filesystem::filesystem_error if a file cannot be opened, read or written, std::system_error if the
+// io_uring cannot be set up, and std::invalid_argument if both paths are the same file, if options.chunk_size is 0,
+// if options.backend is not available, or if the input file is not an encrypted file.
+std::size_t encrypt_file_async(symcrypt_base& symcrypt, const std::filesystem::path& input_path,
+                               const std::filesystem::path& output_path,
+                               const async_file_options& options = async_file_options(),
+                               const execution_policy& policy = execution_policy::automatic());
+std::size_t decrypt_file_async(const symcrypt_base& symcrypt, const std::filesystem::path& input_path,
+                               const std::filesystem::path& output_path,
+                               const async_file_options& options = async_file_options(),
+                               const execution_policy& policy = execution_policy::automatic());
+
+// Encrypts/decrypts many files at once, with the executor of the symcrypt.
+// The files are processed largest first by min(executor concurrency() + 1, file count, policy max_thread_count())
+// tasks (one task with a sequential policy, and no max_thread_count() limit if it is 0): concurrency() excludes the
+// calling thread, which runs one of the tasks. Each task takes the next file when it is done with the previous one.
+// A file large enough for the policy is itself split into chunks, which idle threads of a work-stealing executor
+// (like thread_pool) can take over. So small files do not leave threads idle and large files do not oversubscribe
+// the executor.
+class bulk_file_job
+{
+public:
+    struct progress
+    {
+        std::size_t file_count;
+        std::size_t done_file_count;
+        // Sizes of the input files.
+        std::size_t byte_count;
+        std::size_t done_byte_count;
+    };
+    // Called each time a file is done, from the thread which processed it (one call at a time).
+    using progress_function = std::function<void(const progress&)>;
+
+    // The symcrypt must outlive the job.
+    explicit bulk_file_job(symcrypt_base& symcrypt);
+
+    // Adds a file to process into output_path.
+    void add_file(const std::filesystem::path& input_path, const std::filesystem::path& output_path);
+    // Adds the regular files of the input directory and of its subdirectories.
+    // The output files have the same paths, relative to output_directory.
+    void add_directory(const std::filesystem::path& input_directory, const std::filesystem::path& output_directory);
+    inline std::size_t file_count() const { return files_.size(); }
+
+    inline void set_progress_function(progress_function function) { progress_function_ = std::move(function); }
+
+    // Encrypts/decrypts the files, as encrypt_file()/decrypt_file() do, and returns the total size of the output files.
+    // Unless the policy is sequential, the files are spread over the threads of the executor of the symcrypt, whatever
+    // their sizes: the parallel threshold of an automatic policy only applies to the transform of each file.
+    // Missing output directories are created.
+    // All the files are processed even if some fail: the first error is then thrown, as by encrypt_file() and
+    // decrypt_file(), and the output files of the failed files are removed.
+    std::size_t encrypt(const execution_policy& policy = execution_policy::automatic());
+    std::size_t decrypt(const execution_policy& policy = execution_policy::automatic());
+
+private:
+    struct file_paths
+    {
+        std::filesystem::path input_path;
+        std::filesystem::path output_path;
+    };
+
+    template <class FileFunction>
+    std::size_t run_(const execution_policy& policy, FileFunction process_file);
+
+private:
+    symcrypt_base* symcrypt_;
+    std::vector<file_paths> files_;
+    progress_function progress_function_;
+};
+
+} // namespace cryp
+} // namespace arba
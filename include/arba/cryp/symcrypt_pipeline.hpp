@@ -0,0 +1,53 @@
+#pragma once
+
+#include <arba/cryp/execution_policy.hpp>
+#include <arba/cryp/symcrypt_base.hpp>
+#include <arba/cryp/symcrypt_stream.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <span>
+#include <vector>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Reads at most buffer.size() bytes into buffer, and returns the number of bytes read. 0 means the end of the input.
+using chunk_source = std::function<std::size_t(std::span<std::byte> buffer)>;
+// Writes the bytes of a chunk.
+using chunk_sink = std::function<void(std::span<const std::byte> bytes)>;
+
+chunk_source make_memory_source(std::span<const std::byte> bytes);
+chunk_source make_stream_source(std::istream& stream);
+chunk_sink make_vector_sink(std::vector<std::byte>& bytes);
+chunk_sink make_stream_sink(std::ostream& stream);
+
+struct pipeline_options
+{
+    inline constexpr static std::size_t default_chunk_size = 1024 * 1024;
+
+    // Size of the chunks read from the source.
+    std::size_t chunk_size = default_chunk_size;
+    // Number of chunk buffers. 0 means twice the number of threads of the executor, plus 2.
+    std::size_t buffer_count = 0;
+};
+
+// Encrypts/decrypts the stream read from source into sink, with the format of symcrypt_encoder/symcrypt_decoder.
+// The work is split in three overlapping stages: a thread reads chunks from the source, a thread encrypts/decrypts
+// the chunks read so far with the executor of the symcrypt (as allowed by the policy), and the calling thread writes
+// the chunks into the sink, in order. The chunks are stored in a ring of buffer_count reusable buffers: the reading
+// stage waits for a buffer written by the writing stage, so the memory used does not depend on the input size.
+// Returns the number of bytes written into the sink.
+// If the source, the sink or the transform throws, the pipeline stops and the first exception is rethrown.
+// decrypt_pipeline() throws std::invalid_argument if the stream is truncated or inconsistent.
+std::size_t encrypt_pipeline(symcrypt_base& symcrypt, const chunk_source& source, const chunk_sink& sink,
+                             const pipeline_options& options = pipeline_options(),
+                             const execution_policy& policy = execution_policy::automatic());
+std::size_t decrypt_pipeline(const symcrypt_base& symcrypt, const chunk_source& source, const chunk_sink& sink,
+                             const pipeline_options& options = pipeline_options(),
+                             const execution_policy& policy = execution_policy::automatic());
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <arba/cryp/byte_transform.hpp>
+#include <arba/cryp/keystream.hpp>
+#include <arba/cryp/symcrypt_base.hpp>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <span>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Encrypts any range of data into the ciphertext that symcrypt_base::encrypt() would produce, without the rest of
+// the data. The random bytes are drawn at construction, and the trailer of the ciphertext (its bytes after the data)
+// is known from then on: the ranges can be encrypted in any order, by several threads.
+class symcrypt_range_encryptor
+{
+public:
+    // data_size is the size of the whole data.
+    symcrypt_range_encryptor(symcrypt_base& symcrypt, std::size_t data_size);
+
+    inline std::size_t data_size() const { return data_size_; }
+    // Size of the ciphertext: symcrypt_base::encrypted_size(data_size()).
+    inline std::size_t encrypted_size() const { return data_size_ + trailer_size_; }
+    // End of the ciphertext, to store after the data: the padding, the size byte and the offsets.
+    inline std::span<const std::byte> trailer() const { return std::span(trailer_).first(trailer_size_); }
+
+    // Encrypts the data byte at offset, which must be lower than data_size().
+    inline std::byte encrypt_byte(std::size_t offset, std::byte byte) const
+    {
+        return static_cast<std::byte>(cryp::encrypt_byte(static_cast<uint8_t>(byte), keystream_[offset]));
+    }
+    // Encrypts input, the data bytes starting at offset, into output.
+    // Throws std::out_of_range if the range ends after data_size(),
+    // or std::invalid_argument if output is smaller than input.
+    void encrypt_range(std::size_t offset, std::span<const std::byte> input, std::span<std::byte> output) const;
+    // Encrypts bytes in place, the data bytes starting at offset.
+    // Throws std::out_of_range if the range ends after data_size().
+    void encrypt_range(std::size_t offset, std::span<std::byte> bytes) const;
+
+private:
+    symcrypt_range_encryptor(const symcrypt_base& symcrypt, std::size_t data_size,
+                             const symcrypt_base::random_bytes_array& random_bytes);
+
+private:
+    std::size_t data_size_;
+    std::size_t trailer_size_;
+    std::array<std::byte, symcrypt_base::min_encrypted_size> trailer_;
+    keystream keystream_;
+};
+
+// Decrypts any range of the data of a ciphertext produced by symcrypt_base::encrypt(), without the rest of it.
+// Only the trailer of the ciphertext (its last trailer_size bytes) is needed to build it: as the crypto offset of a
+// byte only depends on its index, the encrypted bytes of a range can be decrypted on their own.
+class symcrypt_range_decryptor
+{
+public:
+    using trailer_span = std::span<const std::byte, symcrypt_base::trailer_size>;
+
+    // encrypted_size is the size of the whole ciphertext.
+    // Throws std::invalid_argument if encrypted_size is smaller than symcrypt_base::min_encrypted_size.
+    symcrypt_range_decryptor(const symcrypt_base& symcrypt, trailer_span trailer, std::size_t encrypted_size);
+
+    // Size of the decrypted data.
+    inline std::size_t data_size() const { return data_size_; }
+
+    // Decrypts the encrypted data byte at offset, which must be lower than data_size().
+    inline std::byte decrypt_byte(std::size_t offset, std::byte encrypted_byte) const
+    {
+        return static_cast<std::byte>(cryp::decrypt_byte(static_cast<uint8_t>(encrypted_byte), keystream_[offset]));
+    }
+    // Decrypts input, the encrypted data bytes starting at offset, into output.
+    // Throws std::out_of_range if the range ends after data_size(),
+    // or std::invalid_argument if output is smaller than input.
+    void decrypt_range(std::size_t offset, std::span<const std::byte> input, std::span<std::byte> output) const;
+    // Decrypts bytes in place, the encrypted data bytes starting at offset.
+    // Throws std::out_of_range if the range ends after data_size().
+    void decrypt_range(std::size_t offset, std::span<std::byte> bytes) const;
+
+private:
+    symcrypt_range_decryptor(const key_schedule& schedule, keystream::offsets_span offsets,
+                             std::byte encrypted_size_byte, std::size_t encrypted_size);
+
+private:
+    keystream keystream_;
+    std::size_t data_size_;
+};
+
+// Reads ranges of decrypted data from a ciphertext stored elsewhere (a file, a remote blob, ...).
+// Only the trailer and the requested ranges are fetched.
+class symcrypt_range_reader
+{
+public:
+    // Fills bytes with the bytes of the ciphertext starting at offset.
+    using read_at_function = std::function<void(std::size_t offset, std::span<std::byte> bytes)>;
+
+    // The trailer is fetched at construction.
+    // Throws std::invalid_argument if encrypted_size is smaller than symcrypt_base::min_encrypted_size.
+    symcrypt_range_reader(const symcrypt_base& symcrypt, std::size_t encrypted_size, read_at_function read_at);
+
+    inline std::size_t data_size() const { return decryptor_.data_size(); }
+    inline const symcrypt_range_decryptor& decryptor() const { return decryptor_; }
+
+    // Reads output.size() bytes of decrypted data, starting at offset.
+    // Throws std::out_of_range if the range ends after data_size().
+    void read(std::size_t offset, std::span<std::byte> output) const;
+
+private:
+    static symcrypt_range_decryptor make_decryptor_(const symcrypt_base& symcrypt, std::size_t encrypted_size,
+                                                    const read_at_function& read_at);
+
+private:
+    read_at_function read_at_;
+    symcrypt_range_decryptor decryptor_;
+};
+
+} // namespace cryp
+} // namespace arba
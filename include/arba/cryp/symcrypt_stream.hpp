@@ -0,0 +1,135 @@
+#pragma once
+
+#include <arba/cryp/key_schedule.hpp>
+#include <arba/cryp/keystream.hpp>
+#include <arba/cryp/symcrypt_base.hpp>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Stream format of symcrypt: [ 8 offsets | data | random padding up to min_data_size | size byte ].
+// It is the format of symcrypt_base::encrypt() where the offsets are moved up front, so that a stream can be
+// encrypted and decrypted chunk by chunk, with constant memory.
+struct symcrypt_stream_format
+{
+    // Size of the hidden offsets, at the beginning of the stream.
+    inline constexpr static std::size_t header_size = keystream::offsets_size;
+    // Maximal size of the padding and of the size byte, at the end of the stream.
+    inline constexpr static std::size_t max_trailer_size = symcrypt_base::min_data_size + 1;
+
+    // Size of the encrypted stream of data_size bytes.
+    inline constexpr static std::size_t encrypted_size(std::size_t data_size)
+    {
+        return symcrypt_base::encrypted_size(data_size);
+    }
+
+    // Size of the data of a stream whose body (what follows the header) is body_size bytes long,
+    // and whose decrypted size byte (the last byte of the body) is size_byte.
+    // Throws std::invalid_argument if the stream is truncated or inconsistent.
+    static std::size_t decrypted_data_size(std::size_t body_size, uint8_t size_byte);
+};
+
+// Encrypts a stream chunk by chunk.
+// The key schedule of the symcrypt is shared when the encoder is created, so that a later change of key does not
+// alter the stream. The symcrypt provides the random bytes and must outlive the encoder.
+class symcrypt_encoder : public symcrypt_stream_format
+{
+public:
+    explicit symcrypt_encoder(symcrypt_base& symcrypt);
+
+    // Maximal number of bytes written by update(input) and by finish().
+    inline constexpr static std::size_t max_update_size(std::size_t input_size) { return header_size + input_size; }
+    inline constexpr static std::size_t max_finish_size() { return header_size + max_trailer_size; }
+
+    // Encrypts input into output, and returns the number of bytes written.
+    // The header is written by the first call to update() or finish().
+    // Throws std::invalid_argument if output is too small (max_update_size(input.size()) is always enough),
+    // or std::logic_error if the stream is already finished.
+    std::size_t update(std::span<const std::byte> input, std::span<std::byte> output);
+    // Writes the end of the stream into output, and returns the number of bytes written.
+    // Throws std::invalid_argument if output is too small (max_finish_size() is always enough),
+    // or std::logic_error if the stream is already finished.
+    std::size_t finish(std::span<std::byte> output);
+
+    // Concurrent encryption of the chunks of a stream:
+    // write_header() writes the header into output if it is not written yet, and returns the number of bytes written.
+    // encrypt_at() encrypts the chunk of data starting at data_index in the stream into output (of the same size).
+    // It does not change the encoder, so several threads can encrypt different chunks at once.
+    // advance(size) then accounts for size bytes encrypted with encrypt_at(), as if they were encrypted by update().
+    // Throws std::invalid_argument if output is too small, or std::logic_error if the stream is already finished.
+    std::size_t write_header(std::span<std::byte> output);
+    void encrypt_at(std::size_t data_index, std::span<const std::byte> input, std::span<std::byte> output) const;
+    void advance(std::size_t size);
+
+    // Number of data bytes encrypted so far.
+    inline std::size_t data_size() const { return data_size_; }
+    inline bool is_finished() const { return finished_; }
+
+private:
+    static std::array<uint8_t, header_size> generate_offsets_(symcrypt_base& symcrypt);
+    std::size_t write_header_(std::byte* output);
+
+private:
+    symcrypt_base* symcrypt_;
+    std::shared_ptr<const key_schedule> key_schedule_;
+    std::array<uint8_t, header_size> offsets_;
+    keystream keystream_;
+    std::size_t data_size_ = 0;
+    bool header_is_written_ = false;
+    bool finished_ = false;
+};
+
+// Decrypts a stream chunk by chunk.
+// The last max_trailer_size bytes received are held back until finish(), as they may be padding.
+class symcrypt_decoder : public symcrypt_stream_format
+{
+public:
+    explicit symcrypt_decoder(const symcrypt_base& symcrypt);
+
+    // Maximal number of bytes written by update(input) and by finish().
+    inline constexpr static std::size_t max_update_size(std::size_t input_size) { return input_size; }
+    inline constexpr static std::size_t max_finish_size() { return symcrypt_base::min_data_size; }
+
+    // Decrypts input into output, and returns the number of bytes written.
+    // Throws std::invalid_argument if output is too small (max_update_size(input.size()) is always enough),
+    // or std::logic_error if the stream is already finished.
+    std::size_t update(std::span<const std::byte> input, std::span<std::byte> output);
+    // Decrypts the held back bytes into output, and returns the number of bytes written.
+    // Throws std::invalid_argument if output is too small (max_finish_size() is always enough), or if the stream is
+    // truncated or inconsistent. Throws std::logic_error if the stream is already finished.
+    std::size_t finish(std::span<std::byte> output);
+
+    // Concurrent decryption of the chunks of a stream:
+    // read_header() reads the beginning of the header from input, and returns the number of bytes read.
+    // decrypt_at() decrypts the chunk of the stream body (data, padding and size byte) starting at body_index into
+    // output (of the same size). It does not change the decoder, so several threads can decrypt different chunks at
+    // once. The data size is then given by decrypted_data_size().
+    // decrypt_at() throws std::logic_error if the header is not read, and std::invalid_argument if output is too small.
+    std::size_t read_header(std::span<const std::byte> input);
+    void decrypt_at(std::size_t body_index, std::span<const std::byte> input, std::span<std::byte> output) const;
+    inline bool header_is_read() const { return keystream_.has_value(); }
+
+    // Number of data bytes decrypted so far.
+    inline std::size_t data_size() const { return data_size_; }
+    inline bool is_finished() const { return finished_; }
+
+private:
+    std::shared_ptr<const key_schedule> key_schedule_;
+    std::array<uint8_t, header_size> header_;
+    std::size_t read_header_size_ = 0;
+    std::optional<keystream> keystream_;
+    std::array<uint8_t, max_trailer_size> held_bytes_;
+    std::size_t held_size_ = 0;
+    std::size_t data_size_ = 0;
+    bool finished_ = false;
+};
+
+} // namespace cryp
+} // namespace arba
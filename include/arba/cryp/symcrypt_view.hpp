@@ -0,0 +1,204 @@
+#pragma once
+
+#include <arba/cryp/symcrypt_base.hpp>
+#include <arba/cryp/symcrypt_range.hpp>
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Random access iterator over bytes computed when they are accessed, by source->byte_at(index).
+template <class Source>
+class lazy_byte_iterator
+{
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    // The bytes are returned by value.
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::byte;
+    using difference_type = std::ptrdiff_t;
+
+    lazy_byte_iterator() = default;
+    inline lazy_byte_iterator(const Source* source, std::size_t index) : source_(source), index_(index) {}
+
+    inline std::size_t index() const { return index_; }
+
+    inline std::byte operator*() const { return source_->byte_at(index_); }
+    inline std::byte operator[](difference_type n) const { return source_->byte_at(index_ + n); }
+
+    inline lazy_byte_iterator& operator++()
+    {
+        ++index_;
+        return *this;
+    }
+    inline lazy_byte_iterator operator++(int)
+    {
+        lazy_byte_iterator iter = *this;
+        ++index_;
+        return iter;
+    }
+    inline lazy_byte_iterator& operator--()
+    {
+        --index_;
+        return *this;
+    }
+    inline lazy_byte_iterator operator--(int)
+    {
+        lazy_byte_iterator iter = *this;
+        --index_;
+        return iter;
+    }
+    inline lazy_byte_iterator& operator+=(difference_type n)
+    {
+        index_ += n;
+        return *this;
+    }
+    inline lazy_byte_iterator& operator-=(difference_type n)
+    {
+        index_ -= n;
+        return *this;
+    }
+
+    friend inline lazy_byte_iterator operator+(lazy_byte_iterator iter, difference_type n) { return iter += n; }
+    friend inline lazy_byte_iterator operator+(difference_type n, lazy_byte_iterator iter) { return iter += n; }
+    friend inline lazy_byte_iterator operator-(lazy_byte_iterator iter, difference_type n) { return iter -= n; }
+    friend inline difference_type operator-(const lazy_byte_iterator& left, const lazy_byte_iterator& right)
+    {
+        return static_cast<difference_type>(left.index_) - static_cast<difference_type>(right.index_);
+    }
+    friend inline bool operator==(const lazy_byte_iterator& left, const lazy_byte_iterator& right)
+    {
+        return left.index_ == right.index_;
+    }
+    friend inline std::strong_ordering operator<=>(const lazy_byte_iterator& left, const lazy_byte_iterator& right)
+    {
+        return left.index_ <=> right.index_;
+    }
+
+private:
+    const Source* source_ = nullptr;
+    std::size_t index_ = 0;
+};
+
+// View of the data of a ciphertext produced by symcrypt_base::encrypt(), decrypted when they are accessed: the
+// ciphertext is neither copied nor modified, and the bytes which are not accessed are not decrypted (a parser can
+// stop early). As the crypto offset of a byte only depends on its index, the view has random access.
+// The trailer is read once, at construction. The ciphertext must outlive the view, not the symcrypt.
+class decrypted_view : public std::ranges::view_interface<decrypted_view>
+{
+    struct source
+    {
+        symcrypt_range_decryptor decryptor;
+        std::span<const std::byte> ciphertext;
+
+        inline std::byte byte_at(std::size_t index) const { return decryptor.decrypt_byte(index, ciphertext[index]); }
+    };
+
+public:
+    using iterator = lazy_byte_iterator<source>;
+
+    decrypted_view() = default;
+    // Throws std::invalid_argument if ciphertext is smaller than symcrypt_base::min_encrypted_size.
+    decrypted_view(const symcrypt_base& symcrypt, std::span<const std::byte> ciphertext);
+
+    inline iterator begin() const { return iterator(source_.get(), 0); }
+    inline iterator end() const { return iterator(source_.get(), size()); }
+    inline std::size_t size() const { return source_ ? source_->decryptor.data_size() : 0; }
+
+    // Decrypts the output.size() bytes starting at offset into output, by blocks.
+    // Throws std::out_of_range if the range ends after size().
+    void copy_to(std::size_t offset, std::span<std::byte> output) const;
+
+private:
+    std::shared_ptr<const source> source_;
+};
+
+// View of the ciphertext of data, as produced by symcrypt_base::encrypt(), encrypted when it is accessed: the data are
+// neither copied nor modified. The random bytes are drawn once, at construction, so the view always shows the same
+// ciphertext. The data must outlive the view, not the symcrypt.
+class encrypted_view : public std::ranges::view_interface<encrypted_view>
+{
+    struct source
+    {
+        symcrypt_range_encryptor encryptor;
+        std::span<const std::byte> data;
+
+        inline std::byte byte_at(std::size_t index) const
+        {
+            return index < data.size() ? encryptor.encrypt_byte(index, data[index])
+                                       : encryptor.trailer()[index - data.size()];
+        }
+    };
+
+public:
+    using iterator = lazy_byte_iterator<source>;
+
+    encrypted_view() = default;
+    encrypted_view(symcrypt_base& symcrypt, std::span<const std::byte> data);
+
+    inline iterator begin() const { return iterator(source_.get(), 0); }
+    inline iterator end() const { return iterator(source_.get(), size()); }
+    // symcrypt_base::encrypted_size() of the data.
+    inline std::size_t size() const { return source_ ? source_->encryptor.encrypted_size() : 0; }
+
+    // Encrypts the output.size() bytes of the ciphertext starting at offset into output, by blocks.
+    // Throws std::out_of_range if the range ends after size().
+    void copy_to(std::size_t offset, std::span<std::byte> output) const;
+
+private:
+    std::shared_ptr<const source> source_;
+};
+
+// Contiguous range of bytes (std::byte, uint8_t, char, ...) which can be viewed after the expression using it.
+template <class Range>
+concept viewable_byte_range =
+    std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range> && std::ranges::borrowed_range<Range>
+    && sizeof(std::ranges::range_value_t<Range>) == 1
+    && std::is_trivially_copyable_v<std::ranges::range_value_t<Range>>;
+
+namespace views
+{
+// Range adaptors: ciphertext | views::decrypted(symcrypt) and data | views::encrypted(symcrypt).
+class decrypted
+{
+public:
+    inline explicit decrypted(const symcrypt_base& symcrypt) : symcrypt_(&symcrypt) {}
+
+    template <viewable_byte_range Range>
+    friend inline decrypted_view operator|(Range&& ciphertext, const decrypted& adaptor)
+    {
+        return decrypted_view(*adaptor.symcrypt_, std::as_bytes(std::span(std::ranges::data(ciphertext),
+                                                                          std::ranges::size(ciphertext))));
+    }
+
+private:
+    const symcrypt_base* symcrypt_;
+};
+
+class encrypted
+{
+public:
+    inline explicit encrypted(symcrypt_base& symcrypt) : symcrypt_(&symcrypt) {}
+
+    template <viewable_byte_range Range>
+    friend inline encrypted_view operator|(Range&& data, const encrypted& adaptor)
+    {
+        return encrypted_view(*adaptor.symcrypt_,
+                              std::as_bytes(std::span(std::ranges::data(data), std::ranges::size(data))));
+    }
+
+private:
+    symcrypt_base* symcrypt_;
+};
+} // namespace views
+
+} // namespace cryp
+} // namespace arba
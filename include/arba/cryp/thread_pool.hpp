@@ -0,0 +1,62 @@
+#pragma once
+
+#include <arba/cryp/executor.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+inline namespace arba
+{
+namespace cryp
+{
+// Work-stealing thread pool.
+// Each worker has its own task queue: it runs its most recent tasks first, and steals the oldest tasks of the other
+// workers when its queue is empty.
+class thread_pool : public executor
+{
+public:
+    using task_type = std::function<void()>;
+
+    explicit thread_pool(std::size_t thread_count = std::thread::hardware_concurrency());
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    // Waits for all the submitted tasks to be done.
+    ~thread_pool() override;
+
+    std::size_t concurrency() const override;
+    void bulk_execute(std::size_t task_count, const std::function<void(std::size_t)>& task) override;
+
+    // The task is pushed in the queue of the calling worker, or in the queue of a worker chosen in turn.
+    // The task should report its errors itself: an exception thrown by it is caught and dropped, so that the thread
+    // running it (a worker, or a thread helping the workers in bulk_execute()) goes on.
+    void submit(task_type task);
+
+private:
+    struct task_queue
+    {
+        std::mutex mutex;
+        std::deque<task_type> tasks;
+    };
+
+    void run_worker_(std::size_t worker_index);
+    std::optional<task_type> try_pop_task_(std::size_t worker_index);
+    std::size_t current_worker_index_() const;
+
+private:
+    std::vector<std::unique_ptr<task_queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic_size_t next_queue_index_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_condition_;
+    std::atomic_size_t pending_task_count_ = 0;
+    bool stopping_ = false;
+};
+
+} // namespace cryp
+} // namespace arba
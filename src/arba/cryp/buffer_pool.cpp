@@ -0,0 +1,93 @@
+#include <arba/cryp/buffer_pool.hpp>
+#include <arba/cryp/symcrypt_base.hpp>
+
+#include <algorithm>
+#include <utility>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+constexpr auto capacity_of = [](const std::vector<uint8_t>& bytes) { return bytes.capacity(); };
+} // namespace
+
+buffer_pool::buffer::buffer(buffer_pool& pool, std::vector<uint8_t>&& bytes) : pool_(&pool), bytes_(std::move(bytes))
+{
+}
+
+buffer_pool::buffer::buffer(buffer&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)), bytes_(std::move(other.bytes_))
+{
+}
+
+buffer_pool::buffer& buffer_pool::buffer::operator=(buffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (pool_)
+            pool_->release_(std::move(bytes_));
+        pool_ = std::exchange(other.pool_, nullptr);
+        bytes_ = std::move(other.bytes_);
+    }
+    return *this;
+}
+
+buffer_pool::buffer::~buffer()
+{
+    if (pool_)
+        pool_->release_(std::move(bytes_));
+}
+
+buffer_pool::buffer_pool(std::size_t max_buffer_count) : max_buffer_count_(max_buffer_count)
+{
+    buffers_.reserve(max_buffer_count_);
+}
+
+buffer_pool::buffer buffer_pool::acquire(std::size_t data_size)
+{
+    const std::size_t capacity = symcrypt_base::encrypted_size(data_size);
+    // The buffers are sorted by capacity.
+    auto iter = std::ranges::lower_bound(buffers_, capacity, std::less{}, capacity_of);
+    std::vector<uint8_t> bytes;
+    if (iter != buffers_.end())
+    {
+        bytes = std::move(*iter);
+        buffers_.erase(iter);
+    }
+    else
+        bytes.reserve(capacity);
+    return buffer(*this, std::move(bytes));
+}
+
+void buffer_pool::clear()
+{
+    buffers_.clear();
+}
+
+buffer_pool& buffer_pool::local()
+{
+    thread_local buffer_pool pool;
+    return pool;
+}
+
+void buffer_pool::release_(std::vector<uint8_t>&& bytes) noexcept
+{
+    if (bytes.capacity() == 0)
+        return;
+    bytes.clear();
+    auto iter = std::ranges::lower_bound(buffers_, bytes.capacity(), std::less{}, capacity_of);
+    if (buffers_.size() < max_buffer_count_)
+        buffers_.insert(iter, std::move(bytes));
+    else if (iter != buffers_.begin())
+    {
+        // The pool is full: the smallest buffer is freed, if it is smaller than this one.
+        std::move(buffers_.begin() + 1, iter, buffers_.begin());
+        *(iter - 1) = std::move(bytes);
+    }
+}
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,657 @@
+#include <arba/cryp/byte_transform.hpp>
+
+#include <array>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define ARBA_CRYP_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define ARBA_CRYP_X86 0
+#endif
+
+#if ARBA_CRYP_X86 == 1 && (defined(__GNUC__) || defined(__clang__))
+#define ARBA_CRYP_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ARBA_CRYP_TARGET(isa)
+#endif
+
+inline namespace arba
+{
+namespace cryp
+{
+
+std::string_view to_string_view(instruction_set iset)
+{
+    switch (iset)
+    {
+    case instruction_set::scalar:
+        return "scalar";
+    case instruction_set::sse4:
+        return "sse4";
+    case instruction_set::avx2:
+        return "avx2";
+    case instruction_set::avx512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+std::string_view to_string_view(byte_transform_mode mode)
+{
+    switch (mode)
+    {
+    case byte_transform_mode::arithmetic:
+        return "arithmetic";
+    case byte_transform_mode::lookup_table:
+        return "lookup_table";
+    }
+    return "unknown";
+}
+
+namespace
+{
+using bytes_kernel = void (*)(const uint8_t*, uint8_t*, const uint8_t*, std::size_t);
+using reencrypt_bytes_kernel = void (*)(const uint8_t*, uint8_t*, const uint8_t*, const uint8_t*, std::size_t);
+
+// scalar kernels
+
+void encrypt_bytes_scalar(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+        output[i] = encrypt_byte(input[i], crypto_offsets[i]);
+}
+
+void decrypt_bytes_scalar(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+        output[i] = decrypt_byte(input[i], crypto_offsets[i]);
+}
+
+void reencrypt_bytes_scalar(const uint8_t* input, uint8_t* output, const uint8_t* old_crypto_offsets,
+                            const uint8_t* new_crypto_offsets, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+        output[i] = encrypt_byte(decrypt_byte(input[i], old_crypto_offsets[i]), new_crypto_offsets[i]);
+}
+
+// lookup table kernels
+
+// The rotation count only depends on the rotated byte and on the popcount of the crypto offset. So, instead of a
+// 256x256 table, there is one 256-byte row per popcount of crypto offset (0 to 8), and the tables stay in L1 cache.
+struct rotation_tables
+{
+    rotation_tables()
+    {
+        for (unsigned byte = 0; byte < 256; ++byte)
+        {
+            const uint8_t value = static_cast<uint8_t>(byte);
+            popcounts[byte] = static_cast<uint8_t>(std::popcount(value));
+            for (int offset_popcount = 0; offset_popcount <= 8; ++offset_popcount)
+            {
+                left_rotations[offset_popcount][byte] = std::rotl(value, std::popcount(value) * offset_popcount);
+                right_rotations[offset_popcount][byte] = std::rotr(value, std::popcount(value) * offset_popcount);
+            }
+        }
+    }
+
+    std::array<uint8_t, 256> popcounts;
+    std::array<std::array<uint8_t, 256>, 9> left_rotations;
+    std::array<std::array<uint8_t, 256>, 9> right_rotations;
+};
+
+// The tables are built on first use.
+const rotation_tables& get_rotation_tables()
+{
+    static const rotation_tables tables;
+    return tables;
+}
+
+void encrypt_bytes_lookup_table(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets,
+                                std::size_t size)
+{
+    const rotation_tables& tables = get_rotation_tables();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const uint8_t crypto_offset = crypto_offsets[i];
+        output[i] = tables.left_rotations[tables.popcounts[crypto_offset]][uint8_t(input[i] + crypto_offset)];
+    }
+}
+
+void decrypt_bytes_lookup_table(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets,
+                                std::size_t size)
+{
+    const rotation_tables& tables = get_rotation_tables();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const uint8_t crypto_offset = crypto_offsets[i];
+        output[i] = tables.right_rotations[tables.popcounts[crypto_offset]][input[i]] - crypto_offset;
+    }
+}
+
+void reencrypt_bytes_lookup_table(const uint8_t* input, uint8_t* output, const uint8_t* old_crypto_offsets,
+                                  const uint8_t* new_crypto_offsets, std::size_t size)
+{
+    const rotation_tables& tables = get_rotation_tables();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const uint8_t old_crypto_offset = old_crypto_offsets[i];
+        const uint8_t new_crypto_offset = new_crypto_offsets[i];
+        const uint8_t byte = tables.right_rotations[tables.popcounts[old_crypto_offset]][input[i]] - old_crypto_offset;
+        output[i] = tables.left_rotations[tables.popcounts[new_crypto_offset]][uint8_t(byte + new_crypto_offset)];
+    }
+}
+
+#if ARBA_CRYP_X86 == 1
+
+// The vector kernels follow the scalar algorithm lane by lane:
+// - popcount of each byte is computed with a nibble lookup table,
+// - the rotation count (popcount * popcount) % 8 is computed with 16-bit multiplications on even and odd bytes,
+// - the variable rotation is done in three steps (1, 2 and 4 bits) selected by the bits of the rotation count.
+// A right rotation by n is a left rotation by (8 - n) % 8.
+
+// SSE4 kernels
+
+ARBA_CRYP_TARGET("sse4.1") inline __m128i popcount_epi8_sse4(__m128i bytes)
+{
+    const __m128i nibble_popcounts = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low_nibble_mask = _mm_set1_epi8(0x0f);
+    __m128i low_nibbles = _mm_and_si128(bytes, low_nibble_mask);
+    __m128i high_nibbles = _mm_and_si128(_mm_srli_epi16(bytes, 4), low_nibble_mask);
+    return _mm_add_epi8(_mm_shuffle_epi8(nibble_popcounts, low_nibbles),
+                        _mm_shuffle_epi8(nibble_popcounts, high_nibbles));
+}
+
+ARBA_CRYP_TARGET("sse4.1") inline __m128i rotation_count_epi8_sse4(__m128i lhs, __m128i rhs)
+{
+    const __m128i even_mask = _mm_set1_epi16(0x00ff);
+    const __m128i odd_mask = _mm_set1_epi16(static_cast<short>(0xff00));
+    __m128i even_products = _mm_and_si128(_mm_mullo_epi16(lhs, rhs), even_mask);
+    __m128i odd_products = _mm_mullo_epi16(_mm_srli_epi16(lhs, 8), _mm_and_si128(rhs, odd_mask));
+    return _mm_and_si128(_mm_or_si128(even_products, odd_products), _mm_set1_epi8(7));
+}
+
+template <int count>
+ARBA_CRYP_TARGET("sse4.1")
+inline __m128i rotl_epi8_sse4(__m128i bytes, __m128i counts)
+{
+    const __m128i high_mask = _mm_set1_epi8(static_cast<char>(0xff << count));
+    const __m128i low_mask = _mm_set1_epi8(static_cast<char>(0xff >> (8 - count)));
+    __m128i rotated = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(bytes, count), high_mask),
+                                   _mm_and_si128(_mm_srli_epi16(bytes, 8 - count), low_mask));
+    const __m128i count_bit = _mm_set1_epi8(count);
+    __m128i selected = _mm_cmpeq_epi8(_mm_and_si128(counts, count_bit), count_bit);
+    return _mm_blendv_epi8(bytes, rotated, selected);
+}
+
+ARBA_CRYP_TARGET("sse4.1") inline __m128i rotl_epi8_sse4(__m128i bytes, __m128i counts)
+{
+    bytes = rotl_epi8_sse4<1>(bytes, counts);
+    bytes = rotl_epi8_sse4<2>(bytes, counts);
+    return rotl_epi8_sse4<4>(bytes, counts);
+}
+
+ARBA_CRYP_TARGET("sse4.1")
+void encrypt_bytes_sse4(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size)
+{
+    constexpr std::size_t width = sizeof(__m128i);
+    std::size_t i = 0;
+    for (; i + width <= size; i += width)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i offsets = _mm_loadu_si128(reinterpret_cast<const __m128i*>(crypto_offsets + i));
+        __m128i aux = _mm_add_epi8(bytes, offsets);
+        __m128i counts = rotation_count_epi8_sse4(popcount_epi8_sse4(aux), popcount_epi8_sse4(offsets));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), rotl_epi8_sse4(aux, counts));
+    }
+    encrypt_bytes_scalar(input + i, output + i, crypto_offsets + i, size - i);
+}
+
+ARBA_CRYP_TARGET("sse4.1")
+void decrypt_bytes_sse4(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size)
+{
+    constexpr std::size_t width = sizeof(__m128i);
+    std::size_t i = 0;
+    for (; i + width <= size; i += width)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i offsets = _mm_loadu_si128(reinterpret_cast<const __m128i*>(crypto_offsets + i));
+        __m128i counts = rotation_count_epi8_sse4(popcount_epi8_sse4(bytes), popcount_epi8_sse4(offsets));
+        counts = _mm_and_si128(_mm_sub_epi8(_mm_setzero_si128(), counts), _mm_set1_epi8(7));
+        __m128i rotated = rotl_epi8_sse4(bytes, counts);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_sub_epi8(rotated, offsets));
+    }
+    decrypt_bytes_scalar(input + i, output + i, crypto_offsets + i, size - i);
+}
+
+// The byte is decrypted and encrypted again in registers, so the data are read and written once.
+ARBA_CRYP_TARGET("sse4.1")
+void reencrypt_bytes_sse4(const uint8_t* input, uint8_t* output, const uint8_t* old_crypto_offsets,
+                          const uint8_t* new_crypto_offsets, std::size_t size)
+{
+    constexpr std::size_t width = sizeof(__m128i);
+    std::size_t i = 0;
+    for (; i + width <= size; i += width)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i old_offsets = _mm_loadu_si128(reinterpret_cast<const __m128i*>(old_crypto_offsets + i));
+        __m128i new_offsets = _mm_loadu_si128(reinterpret_cast<const __m128i*>(new_crypto_offsets + i));
+        __m128i counts = rotation_count_epi8_sse4(popcount_epi8_sse4(bytes), popcount_epi8_sse4(old_offsets));
+        counts = _mm_and_si128(_mm_sub_epi8(_mm_setzero_si128(), counts), _mm_set1_epi8(7));
+        __m128i aux = _mm_add_epi8(_mm_sub_epi8(rotl_epi8_sse4(bytes, counts), old_offsets), new_offsets);
+        counts = rotation_count_epi8_sse4(popcount_epi8_sse4(aux), popcount_epi8_sse4(new_offsets));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), rotl_epi8_sse4(aux, counts));
+    }
+    reencrypt_bytes_scalar(input + i, output + i, old_crypto_offsets + i, new_crypto_offsets + i, size - i);
+}
+
+// AVX2 kernels
+
+ARBA_CRYP_TARGET("avx2") inline __m256i popcount_epi8_avx2(__m256i bytes)
+{
+    const __m256i nibble_popcounts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, //
+                                                      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibble_mask = _mm256_set1_epi8(0x0f);
+    __m256i low_nibbles = _mm256_and_si256(bytes, low_nibble_mask);
+    __m256i high_nibbles = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_nibble_mask);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(nibble_popcounts, low_nibbles),
+                           _mm256_shuffle_epi8(nibble_popcounts, high_nibbles));
+}
+
+ARBA_CRYP_TARGET("avx2") inline __m256i rotation_count_epi8_avx2(__m256i lhs, __m256i rhs)
+{
+    const __m256i even_mask = _mm256_set1_epi16(0x00ff);
+    const __m256i odd_mask = _mm256_set1_epi16(static_cast<short>(0xff00));
+    __m256i even_products = _mm256_and_si256(_mm256_mullo_epi16(lhs, rhs), even_mask);
+    __m256i odd_products = _mm256_mullo_epi16(_mm256_srli_epi16(lhs, 8), _mm256_and_si256(rhs, odd_mask));
+    return _mm256_and_si256(_mm256_or_si256(even_products, odd_products), _mm256_set1_epi8(7));
+}
+
+template <int count>
+ARBA_CRYP_TARGET("avx2")
+inline __m256i rotl_epi8_avx2(__m256i bytes, __m256i counts)
+{
+    const __m256i high_mask = _mm256_set1_epi8(static_cast<char>(0xff << count));
+    const __m256i low_mask = _mm256_set1_epi8(static_cast<char>(0xff >> (8 - count)));
+    __m256i rotated = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi16(bytes, count), high_mask),
+                                      _mm256_and_si256(_mm256_srli_epi16(bytes, 8 - count), low_mask));
+    const __m256i count_bit = _mm256_set1_epi8(count);
+    __m256i selected = _mm256_cmpeq_epi8(_mm256_and_si256(counts, count_bit), count_bit);
+    return _mm256_blendv_epi8(bytes, rotated, selected);
+}
+
+ARBA_CRYP_TARGET("avx2") inline __m256i rotl_epi8_avx2(__m256i bytes, __m256i counts)
+{
+    bytes = rotl_epi8_avx2<1>(bytes, counts);
+    bytes = rotl_epi8_avx2<2>(bytes, counts);
+    return rotl_epi8_avx2<4>(bytes, counts);
+}
+
+ARBA_CRYP_TARGET("avx2")
+void encrypt_bytes_avx2(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size)
+{
+    constexpr std::size_t width = sizeof(__m256i);
+    std::size_t i = 0;
+    for (; i + width <= size; i += width)
+    {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(crypto_offsets + i));
+        __m256i aux = _mm256_add_epi8(bytes, offsets);
+        __m256i counts = rotation_count_epi8_avx2(popcount_epi8_avx2(aux), popcount_epi8_avx2(offsets));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), rotl_epi8_avx2(aux, counts));
+    }
+    encrypt_bytes_sse4(input + i, output + i, crypto_offsets + i, size - i);
+}
+
+ARBA_CRYP_TARGET("avx2")
+void decrypt_bytes_avx2(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size)
+{
+    constexpr std::size_t width = sizeof(__m256i);
+    std::size_t i = 0;
+    for (; i + width <= size; i += width)
+    {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(crypto_offsets + i));
+        __m256i counts = rotation_count_epi8_avx2(popcount_epi8_avx2(bytes), popcount_epi8_avx2(offsets));
+        counts = _mm256_and_si256(_mm256_sub_epi8(_mm256_setzero_si256(), counts), _mm256_set1_epi8(7));
+        __m256i rotated = rotl_epi8_avx2(bytes, counts);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_sub_epi8(rotated, offsets));
+    }
+    decrypt_bytes_sse4(input + i, output + i, crypto_offsets + i, size - i);
+}
+
+ARBA_CRYP_TARGET("avx2")
+void reencrypt_bytes_avx2(const uint8_t* input, uint8_t* output, const uint8_t* old_crypto_offsets,
+                          const uint8_t* new_crypto_offsets, std::size_t size)
+{
+    constexpr std::size_t width = sizeof(__m256i);
+    std::size_t i = 0;
+    for (; i + width <= size; i += width)
+    {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i old_offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(old_crypto_offsets + i));
+        __m256i new_offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(new_crypto_offsets + i));
+        __m256i counts = rotation_count_epi8_avx2(popcount_epi8_avx2(bytes), popcount_epi8_avx2(old_offsets));
+        counts = _mm256_and_si256(_mm256_sub_epi8(_mm256_setzero_si256(), counts), _mm256_set1_epi8(7));
+        __m256i aux = _mm256_add_epi8(_mm256_sub_epi8(rotl_epi8_avx2(bytes, counts), old_offsets), new_offsets);
+        counts = rotation_count_epi8_avx2(popcount_epi8_avx2(aux), popcount_epi8_avx2(new_offsets));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), rotl_epi8_avx2(aux, counts));
+    }
+    reencrypt_bytes_sse4(input + i, output + i, old_crypto_offsets + i, new_crypto_offsets + i, size - i);
+}
+
+// AVX-512 kernels
+
+ARBA_CRYP_TARGET("avx512f,avx512bw") inline __m512i popcount_epi8_avx512(__m512i bytes)
+{
+    // 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 in each 128-bit lane.
+    const __m512i nibble_popcounts = _mm512_set4_epi32(0x04030302, 0x03020201, 0x03020201, 0x02010100);
+    const __m512i low_nibble_mask = _mm512_set1_epi8(0x0f);
+    __m512i low_nibbles = _mm512_and_si512(bytes, low_nibble_mask);
+    __m512i high_nibbles = _mm512_and_si512(_mm512_srli_epi16(bytes, 4), low_nibble_mask);
+    return _mm512_add_epi8(_mm512_shuffle_epi8(nibble_popcounts, low_nibbles),
+                           _mm512_shuffle_epi8(nibble_popcounts, high_nibbles));
+}
+
+ARBA_CRYP_TARGET("avx512f,avx512bw") inline __m512i rotation_count_epi8_avx512(__m512i lhs, __m512i rhs)
+{
+    const __m512i even_mask = _mm512_set1_epi16(0x00ff);
+    const __m512i odd_mask = _mm512_set1_epi16(static_cast<short>(0xff00));
+    __m512i even_products = _mm512_and_si512(_mm512_mullo_epi16(lhs, rhs), even_mask);
+    __m512i odd_products = _mm512_mullo_epi16(_mm512_srli_epi16(lhs, 8), _mm512_and_si512(rhs, odd_mask));
+    return _mm512_and_si512(_mm512_or_si512(even_products, odd_products), _mm512_set1_epi8(7));
+}
+
+template <int count>
+ARBA_CRYP_TARGET("avx512f,avx512bw")
+inline __m512i rotl_epi8_avx512(__m512i bytes, __m512i counts)
+{
+    const __m512i high_mask = _mm512_set1_epi8(static_cast<char>(0xff << count));
+    const __m512i low_mask = _mm512_set1_epi8(static_cast<char>(0xff >> (8 - count)));
+    __m512i rotated = _mm512_or_si512(_mm512_and_si512(_mm512_slli_epi16(bytes, count), high_mask),
+                                      _mm512_and_si512(_mm512_srli_epi16(bytes, 8 - count), low_mask));
+    __mmask64 selected = _mm512_test_epi8_mask(counts, _mm512_set1_epi8(count));
+    return _mm512_mask_blend_epi8(selected, bytes, rotated);
+}
+
+ARBA_CRYP_TARGET("avx512f,avx512bw") inline __m512i rotl_epi8_avx512(__m512i bytes, __m512i counts)
+{
+    bytes = rotl_epi8_avx512<1>(bytes, counts);
+    bytes = rotl_epi8_avx512<2>(bytes, counts);
+    return rotl_epi8_avx512<4>(bytes, counts);
+}
+
+ARBA_CRYP_TARGET("avx512f,avx512bw")
+void encrypt_bytes_avx512(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size)
+{
+    constexpr std::size_t width = sizeof(__m512i);
+    std::size_t i = 0;
+    for (; i + width <= size; i += width)
+    {
+        __m512i bytes = _mm512_loadu_si512(input + i);
+        __m512i offsets = _mm512_loadu_si512(crypto_offsets + i);
+        __m512i aux = _mm512_add_epi8(bytes, offsets);
+        __m512i counts = rotation_count_epi8_avx512(popcount_epi8_avx512(aux), popcount_epi8_avx512(offsets));
+        _mm512_storeu_si512(output + i, rotl_epi8_avx512(aux, counts));
+    }
+    encrypt_bytes_avx2(input + i, output + i, crypto_offsets + i, size - i);
+}
+
+ARBA_CRYP_TARGET("avx512f,avx512bw")
+void decrypt_bytes_avx512(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size)
+{
+    constexpr std::size_t width = sizeof(__m512i);
+    std::size_t i = 0;
+    for (; i + width <= size; i += width)
+    {
+        __m512i bytes = _mm512_loadu_si512(input + i);
+        __m512i offsets = _mm512_loadu_si512(crypto_offsets + i);
+        __m512i counts = rotation_count_epi8_avx512(popcount_epi8_avx512(bytes), popcount_epi8_avx512(offsets));
+        counts = _mm512_and_si512(_mm512_sub_epi8(_mm512_setzero_si512(), counts), _mm512_set1_epi8(7));
+        __m512i rotated = rotl_epi8_avx512(bytes, counts);
+        _mm512_storeu_si512(output + i, _mm512_sub_epi8(rotated, offsets));
+    }
+    decrypt_bytes_avx2(input + i, output + i, crypto_offsets + i, size - i);
+}
+
+ARBA_CRYP_TARGET("avx512f,avx512bw")
+void reencrypt_bytes_avx512(const uint8_t* input, uint8_t* output, const uint8_t* old_crypto_offsets,
+                            const uint8_t* new_crypto_offsets, std::size_t size)
+{
+    constexpr std::size_t width = sizeof(__m512i);
+    std::size_t i = 0;
+    for (; i + width <= size; i += width)
+    {
+        __m512i bytes = _mm512_loadu_si512(input + i);
+        __m512i old_offsets = _mm512_loadu_si512(old_crypto_offsets + i);
+        __m512i new_offsets = _mm512_loadu_si512(new_crypto_offsets + i);
+        __m512i counts = rotation_count_epi8_avx512(popcount_epi8_avx512(bytes), popcount_epi8_avx512(old_offsets));
+        counts = _mm512_and_si512(_mm512_sub_epi8(_mm512_setzero_si512(), counts), _mm512_set1_epi8(7));
+        __m512i aux = _mm512_add_epi8(_mm512_sub_epi8(rotl_epi8_avx512(bytes, counts), old_offsets), new_offsets);
+        counts = rotation_count_epi8_avx512(popcount_epi8_avx512(aux), popcount_epi8_avx512(new_offsets));
+        _mm512_storeu_si512(output + i, rotl_epi8_avx512(aux, counts));
+    }
+    reencrypt_bytes_avx2(input + i, output + i, old_crypto_offsets + i, new_crypto_offsets + i, size - i);
+}
+
+// CPU detection
+
+instruction_set detect_best_instruction_set()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        return instruction_set::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return instruction_set::avx2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return instruction_set::sse4;
+#elif defined(_MSC_VER)
+    int registers[4];
+    __cpuid(registers, 0);
+    const int max_leaf = registers[0];
+    __cpuid(registers, 1);
+    const bool has_sse4 = (registers[2] & (1 << 19)) != 0;
+    const bool has_osxsave = (registers[2] & (1 << 27)) != 0;
+    const unsigned long long xcr0 = has_osxsave ? _xgetbv(0) : 0;
+    const bool os_saves_ymm = (xcr0 & 0x6) == 0x6;
+    const bool os_saves_zmm = (xcr0 & 0xe6) == 0xe6;
+    if (max_leaf >= 7)
+    {
+        __cpuidex(registers, 7, 0);
+        const bool has_avx2 = (registers[1] & (1 << 5)) != 0;
+        const bool has_avx512 = (registers[1] & (1 << 16)) != 0 && (registers[1] & (1 << 30)) != 0;
+        if (has_avx512 && os_saves_zmm)
+            return instruction_set::avx512;
+        if (has_avx2 && os_saves_ymm)
+            return instruction_set::avx2;
+    }
+    if (has_sse4)
+        return instruction_set::sse4;
+#endif
+    return instruction_set::scalar;
+}
+
+#else
+
+instruction_set detect_best_instruction_set()
+{
+    return instruction_set::scalar;
+}
+
+#endif
+
+bytes_kernel encrypt_kernel(instruction_set iset)
+{
+    switch (iset)
+    {
+#if ARBA_CRYP_X86 == 1
+    case instruction_set::avx512:
+        return &encrypt_bytes_avx512;
+    case instruction_set::avx2:
+        return &encrypt_bytes_avx2;
+    case instruction_set::sse4:
+        return &encrypt_bytes_sse4;
+#endif
+    default:
+        return &encrypt_bytes_scalar;
+    }
+}
+
+bytes_kernel decrypt_kernel(instruction_set iset)
+{
+    switch (iset)
+    {
+#if ARBA_CRYP_X86 == 1
+    case instruction_set::avx512:
+        return &decrypt_bytes_avx512;
+    case instruction_set::avx2:
+        return &decrypt_bytes_avx2;
+    case instruction_set::sse4:
+        return &decrypt_bytes_sse4;
+#endif
+    default:
+        return &decrypt_bytes_scalar;
+    }
+}
+
+reencrypt_bytes_kernel reencrypt_kernel(instruction_set iset)
+{
+    switch (iset)
+    {
+#if ARBA_CRYP_X86 == 1
+    case instruction_set::avx512:
+        return &reencrypt_bytes_avx512;
+    case instruction_set::avx2:
+        return &reencrypt_bytes_avx2;
+    case instruction_set::sse4:
+        return &reencrypt_bytes_sse4;
+#endif
+    default:
+        return &reencrypt_bytes_scalar;
+    }
+}
+
+struct dispatch_table
+{
+    instruction_set iset = detect_best_instruction_set();
+    // Kernels of the default mode.
+    std::atomic<byte_transform_mode> mode = byte_transform_mode::arithmetic;
+    std::atomic<bytes_kernel> encrypt = encrypt_kernel(iset);
+    std::atomic<bytes_kernel> decrypt = decrypt_kernel(iset);
+    std::atomic<reencrypt_bytes_kernel> reencrypt = reencrypt_kernel(iset);
+};
+
+dispatch_table& default_kernels()
+{
+    static dispatch_table kernels;
+    return kernels;
+}
+
+} // namespace
+
+instruction_set best_instruction_set()
+{
+    return default_kernels().iset;
+}
+
+bool instruction_set_is_supported(instruction_set iset)
+{
+    return iset <= best_instruction_set();
+}
+
+byte_transform_mode default_byte_transform_mode()
+{
+    return default_kernels().mode.load(std::memory_order_relaxed);
+}
+
+void set_default_byte_transform_mode(byte_transform_mode mode)
+{
+    dispatch_table& kernels = default_kernels();
+    const bool is_lookup_table = mode == byte_transform_mode::lookup_table;
+    if (is_lookup_table)
+        get_rotation_tables();
+    kernels.encrypt.store(is_lookup_table ? &encrypt_bytes_lookup_table : encrypt_kernel(kernels.iset),
+                          std::memory_order_relaxed);
+    kernels.decrypt.store(is_lookup_table ? &decrypt_bytes_lookup_table : decrypt_kernel(kernels.iset),
+                          std::memory_order_relaxed);
+    kernels.reencrypt.store(is_lookup_table ? &reencrypt_bytes_lookup_table : reencrypt_kernel(kernels.iset),
+                            std::memory_order_relaxed);
+    kernels.mode.store(mode, std::memory_order_relaxed);
+}
+
+// encrypt/decrypt bytes
+void encrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size)
+{
+    default_kernels().encrypt.load(std::memory_order_relaxed)(input, output, crypto_offsets, size);
+}
+
+void decrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size)
+{
+    default_kernels().decrypt.load(std::memory_order_relaxed)(input, output, crypto_offsets, size);
+}
+
+void encrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size,
+                   instruction_set iset)
+{
+    if (!instruction_set_is_supported(iset)) [[unlikely]]
+        iset = best_instruction_set();
+    encrypt_kernel(iset)(input, output, crypto_offsets, size);
+}
+
+void decrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size,
+                   instruction_set iset)
+{
+    if (!instruction_set_is_supported(iset)) [[unlikely]]
+        iset = best_instruction_set();
+    decrypt_kernel(iset)(input, output, crypto_offsets, size);
+}
+
+void encrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size,
+                   byte_transform_mode mode)
+{
+    if (mode == byte_transform_mode::lookup_table)
+        encrypt_bytes_lookup_table(input, output, crypto_offsets, size);
+    else
+        encrypt_kernel(best_instruction_set())(input, output, crypto_offsets, size);
+}
+
+void decrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* crypto_offsets, std::size_t size,
+                   byte_transform_mode mode)
+{
+    if (mode == byte_transform_mode::lookup_table)
+        decrypt_bytes_lookup_table(input, output, crypto_offsets, size);
+    else
+        decrypt_kernel(best_instruction_set())(input, output, crypto_offsets, size);
+}
+
+// reencrypt bytes
+void reencrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* old_crypto_offsets,
+                     const uint8_t* new_crypto_offsets, std::size_t size)
+{
+    default_kernels().reencrypt.load(std::memory_order_relaxed)(input, output, old_crypto_offsets, new_crypto_offsets,
+                                                                size);
+}
+
+void reencrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* old_crypto_offsets,
+                     const uint8_t* new_crypto_offsets, std::size_t size, instruction_set iset)
+{
+    if (!instruction_set_is_supported(iset)) [[unlikely]]
+        iset = best_instruction_set();
+    reencrypt_kernel(iset)(input, output, old_crypto_offsets, new_crypto_offsets, size);
+}
+
+void reencrypt_bytes(const uint8_t* input, uint8_t* output, const uint8_t* old_crypto_offsets,
+                     const uint8_t* new_crypto_offsets, std::size_t size, byte_transform_mode mode)
+{
+    if (mode == byte_transform_mode::lookup_table)
+        reencrypt_bytes_lookup_table(input, output, old_crypto_offsets, new_crypto_offsets, size);
+    else
+        reencrypt_kernel(best_instruction_set())(input, output, old_crypto_offsets, new_crypto_offsets, size);
+}
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,23 @@
+#include <arba/cryp/execution_policy.hpp>
+
+#include <algorithm>
+#include <thread>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+std::size_t execution_policy::thread_count(std::size_t data_size) const
+{
+    if (mode_ == mode::sequential || (mode_ == mode::automatic && data_size < parallel_threshold_))
+        return 1;
+
+    std::size_t hardware_thread_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    if (max_thread_count_ == 0)
+        return hardware_thread_count;
+    return std::min(max_thread_count_, hardware_thread_count);
+}
+
+} // namespace cryp
+} // namespace arba
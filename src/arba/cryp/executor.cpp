@@ -0,0 +1,76 @@
+#include <arba/cryp/config.hpp>
+#include <arba/cryp/executor.hpp>
+#include <arba/cryp/thread_pool.hpp>
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#if ARBA_CRYP_PARALLEL_EXECUTION_IS_AVAILABLE == 1
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <vector>
+#endif
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+std::atomic<executor*> default_executor_ptr = nullptr;
+} // namespace
+
+std::size_t std_parallel_executor::concurrency() const
+{
+    if constexpr (parallel_execution_is_available)
+        return std::thread::hardware_concurrency();
+    return 0;
+}
+
+void std_parallel_executor::bulk_execute(std::size_t task_count, const std::function<void(std::size_t)>& task)
+{
+#if ARBA_CRYP_PARALLEL_EXECUTION_IS_AVAILABLE == 1
+    // Parallel algorithms call std::terminate if a task throws, so the first exception is kept and rethrown.
+    std::vector<std::size_t> task_indexes(task_count);
+    std::iota(task_indexes.begin(), task_indexes.end(), 0);
+    std::mutex exception_mutex;
+    std::exception_ptr exception;
+    std::for_each(std::execution::par, task_indexes.begin(), task_indexes.end(),
+                  [&](std::size_t task_index)
+                  {
+                      try
+                      {
+                          task(task_index);
+                      }
+                      catch (...)
+                      {
+                          std::lock_guard lock(exception_mutex);
+                          if (!exception)
+                              exception = std::current_exception();
+                      }
+                  });
+    if (exception)
+        std::rethrow_exception(exception);
+#else
+    for (std::size_t task_index = 0; task_index < task_count; ++task_index)
+        task(task_index);
+#endif
+}
+
+executor& default_executor()
+{
+    if (executor* exec = default_executor_ptr.load(std::memory_order_acquire))
+        return *exec;
+    static thread_pool pool;
+    return pool;
+}
+
+void set_default_executor(executor& exec)
+{
+    default_executor_ptr.store(&exec, std::memory_order_release);
+}
+
+} // namespace cryp
+} // namespace arba
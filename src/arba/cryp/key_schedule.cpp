@@ -0,0 +1,42 @@
+#include <arba/cryp/key_schedule.hpp>
+
+#include <arba/hash/murmur_hash.hpp>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+std::array<uint8_t, 8> uint64_to_array8(uint64_t integer)
+{
+    std::array<uint8_t, 8> array;
+    for (uint8_t& byte : array)
+    {
+        byte = integer % 256;
+        integer /= 256;
+    }
+    return array;
+}
+} // namespace
+
+key_schedule::key_schedule(const crypto_key& key)
+    : key_(key), key_hash_bytes_(compute_key_hash_bytes(key))
+{
+    constexpr std::size_t offsets_size = keystream::offsets_size;
+    for (std::size_t byte_index = 0; byte_index < keystream::period; ++byte_index)
+    {
+        std::size_t offset_index = key.back() + byte_index + (byte_index / (offsets_size + 1));
+        offset_indexes_[byte_index] = static_cast<uint8_t>(offset_index % offsets_size);
+        key_offsets_[byte_index] = static_cast<uint8_t>(byte_index % 256) + key[byte_index % key.size()];
+    }
+}
+
+key_schedule::key_hash_bytes_array key_schedule::compute_key_hash_bytes(const crypto_key& key)
+{
+    return uint64_to_array8(hash::neutral_murmur_hash_64(key.data(), key.size()));
+}
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,158 @@
+#include <arba/cryp/keyring.hpp>
+
+#include <array>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+// Generations are unique among all the keyrings, so that a generation identifies a snapshot of a keyring.
+uint64_t new_generation()
+{
+    static std::atomic<uint64_t> next_generation = 0;
+    return next_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+[[noreturn]] void throw_unknown_key_id(std::string_view key_id)
+{
+    throw std::out_of_range("keyring: unknown key ID '" + std::string(key_id) + "'.");
+}
+
+// The cache does not keep the snapshots alive: only the keyring and the lookups in progress do.
+struct cached_snapshot
+{
+    uint64_t generation = 0;
+    std::weak_ptr<const void> keys;
+};
+
+// A few entries, for the threads using several keyrings.
+thread_local std::array<cached_snapshot, 4> snapshot_cache;
+thread_local std::size_t next_snapshot_entry = 0;
+} // namespace
+
+keyring::keyring() : keys_(std::make_shared<const key_map>()), generation_(new_generation())
+{
+}
+
+void keyring::insert_or_assign(std::string_view key_id, const crypto_key& key)
+{
+    // The key schedule is computed before taking the lock.
+    std::shared_ptr<const key_schedule> schedule = std::make_shared<const key_schedule>(key);
+    update_([&](key_map& keys) { keys.insert_or_assign(std::string(key_id), std::move(schedule)); });
+}
+
+void keyring::insert_or_assign(std::string_view key_id, std::string_view password)
+{
+    insert_or_assign(key_id, symcrypt_base::to_crypto_key(password));
+}
+
+bool keyring::erase(std::string_view key_id)
+{
+    bool erased = false;
+    update_(
+        [&](key_map& keys)
+        {
+            if (auto iter = keys.find(key_id); iter != keys.end())
+            {
+                keys.erase(iter);
+                erased = true;
+            }
+        });
+    return erased;
+}
+
+std::shared_ptr<const keyring::key_map> keyring::snapshot_() const
+{
+    const uint64_t generation = generation_.load(std::memory_order_acquire);
+    for (const cached_snapshot& entry : snapshot_cache)
+        if (entry.generation == generation)
+            if (std::shared_ptr<const void> keys = entry.keys.lock())
+                return std::static_pointer_cast<const key_map>(std::move(keys));
+
+    std::shared_ptr<const key_map> keys;
+    uint64_t keys_generation = 0;
+    {
+        std::shared_lock lock(mutex_);
+        keys = keys_;
+        keys_generation = generation_.load(std::memory_order_relaxed);
+    }
+    cached_snapshot& entry = snapshot_cache[next_snapshot_entry];
+    next_snapshot_entry = (next_snapshot_entry + 1) % snapshot_cache.size();
+    entry.generation = keys_generation;
+    entry.keys = keys;
+    return keys;
+}
+
+template <class SymcryptFunction>
+auto keyring::with_symcrypt_(std::string_view key_id, SymcryptFunction function) const
+{
+    const std::shared_ptr<const key_map> keys = snapshot_();
+    auto iter = keys->find(key_id);
+    if (iter == keys->end()) [[unlikely]]
+        throw_unknown_key_id(key_id);
+    // Aliasing constructor with an empty owner: the reference count of the key schedule is not touched.
+    symcrypt_type symcrypt(std::shared_ptr<const key_schedule>(std::shared_ptr<const void>(), iter->second.get()));
+    return function(symcrypt);
+}
+
+std::shared_ptr<const key_schedule> keyring::find(std::string_view key_id) const
+{
+    const std::shared_ptr<const key_map> keys = snapshot_();
+    auto iter = keys->find(key_id);
+    return iter != keys->end() ? iter->second : nullptr;
+}
+
+std::size_t keyring::size() const
+{
+    return snapshot_()->size();
+}
+
+keyring::symcrypt_type keyring::symcrypt(std::string_view key_id) const
+{
+    std::shared_ptr<const key_schedule> schedule = find(key_id);
+    if (!schedule) [[unlikely]]
+        throw_unknown_key_id(key_id);
+    return symcrypt_type(std::move(schedule));
+}
+
+void keyring::encrypt(std::string_view key_id, std::vector<uint8_t>& bytes, const execution_policy& policy) const
+{
+    with_symcrypt_(key_id, [&](symcrypt_type& symcrypt) { symcrypt.encrypt(bytes, policy); });
+}
+
+void keyring::decrypt(std::string_view key_id, std::vector<uint8_t>& bytes, const execution_policy& policy) const
+{
+    with_symcrypt_(key_id, [&](symcrypt_type& symcrypt) { symcrypt.decrypt(bytes, policy); });
+}
+
+std::size_t keyring::encrypt(std::string_view key_id, std::span<const std::byte> input, std::span<std::byte> output,
+                             const execution_policy& policy) const
+{
+    return with_symcrypt_(key_id, [&](symcrypt_type& symcrypt) { return symcrypt.encrypt(input, output, policy); });
+}
+
+std::size_t keyring::decrypt(std::string_view key_id, std::span<const std::byte> input, std::span<std::byte> output,
+                             const execution_policy& policy) const
+{
+    return with_symcrypt_(key_id, [&](symcrypt_type& symcrypt) { return symcrypt.decrypt(input, output, policy); });
+}
+
+template <class UpdateFunction>
+void keyring::update_(UpdateFunction update)
+{
+    std::unique_lock lock(mutex_);
+    // Readers keep using the former snapshot until the new generation is published.
+    std::shared_ptr<key_map> keys = std::make_shared<key_map>(*keys_);
+    update(*keys);
+    keys_ = std::move(keys);
+    generation_.store(new_generation(), std::memory_order_release);
+}
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,85 @@
+#include <arba/cryp/byte_transform.hpp>
+#include <arba/cryp/key_schedule.hpp>
+#include <arba/cryp/keystream.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+using bytes_transform = void (*)(const uint8_t*, uint8_t*, const uint8_t*, std::size_t);
+
+// Walk the keystream period by period, so that the vectorized kernels can be used on each period.
+void transform(const uint8_t* table, std::size_t table_size, const uint8_t* input, uint8_t* output, std::size_t size,
+               std::size_t first_index, bytes_transform transform_bytes)
+{
+    assert(table_size == keystream::period || first_index + size <= table_size);
+    for (std::size_t table_index = first_index % keystream::period; size > 0; table_index = 0)
+    {
+        const std::size_t count = std::min(size, table_size - table_index);
+        transform_bytes(input, output, table + table_index, count);
+        input += count;
+        output += count;
+        size -= count;
+    }
+}
+} // namespace
+
+static_assert(keystream::period % keystream::key_size == 0);
+static_assert(keystream::period % 256 == 0);
+static_assert(keystream::period % (keystream::offsets_size + 1) == 0);
+static_assert((keystream::period + keystream::period / (keystream::offsets_size + 1)) % keystream::offsets_size == 0);
+
+keystream::keystream(crypto_key_span key, offsets_span offs, std::size_t length) : size_(std::min(length, period))
+{
+    for (std::size_t byte_index = 0; byte_index < size_; ++byte_index)
+        table_[byte_index] = crypto_offset(key, offs, byte_index);
+}
+
+keystream::keystream(const key_schedule& schedule, offsets_span offs, std::size_t length)
+    : size_(std::min(length, period))
+{
+    const uint8_t* key_offsets = schedule.key_offsets().data();
+    const uint8_t* offset_indexes = schedule.offset_indexes().data();
+    for (std::size_t byte_index = 0; byte_index < size_; ++byte_index)
+        table_[byte_index] = key_offsets[byte_index] + offs[offset_indexes[byte_index]];
+}
+
+uint8_t keystream::crypto_offset(const key_schedule& schedule, offsets_span offs, std::size_t byte_index)
+{
+    const std::size_t table_index = byte_index % period;
+    return schedule.key_offsets()[table_index] + offs[schedule.offset_indexes()[table_index]];
+}
+
+void keystream::encrypt(const uint8_t* input, uint8_t* output, std::size_t size, std::size_t first_index) const
+{
+    transform(table_.data(), size_, input, output, size, first_index, &encrypt_bytes);
+}
+
+void keystream::decrypt(const uint8_t* input, uint8_t* output, std::size_t size, std::size_t first_index) const
+{
+    transform(table_.data(), size_, input, output, size, first_index, &decrypt_bytes);
+}
+
+void keystream::reencrypt(const keystream& new_keystream, const uint8_t* input, uint8_t* output, std::size_t size,
+                          std::size_t first_index) const
+{
+    assert(size_ == period || first_index + size <= size_);
+    assert(new_keystream.size_ == period || first_index + size <= new_keystream.size_);
+    for (std::size_t table_index = first_index % period; size > 0; table_index = 0)
+    {
+        const std::size_t count = std::min({ size, size_ - table_index, new_keystream.size_ - table_index });
+        reencrypt_bytes(input, output, table_.data() + table_index, new_keystream.table_.data() + table_index, count);
+        input += count;
+        output += count;
+        size -= count;
+    }
+}
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,105 @@
+#include <arba/cryp/metrics.hpp>
+
+#include <algorithm>
+#include <bit>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+std::string_view to_string_view(metric_counter counter)
+{
+    switch (counter)
+    {
+    case metric_counter::encrypt_calls:
+        return "encrypt_calls";
+    case metric_counter::decrypt_calls:
+        return "decrypt_calls";
+    case metric_counter::encrypted_bytes:
+        return "encrypted_bytes";
+    case metric_counter::decrypted_bytes:
+        return "decrypted_bytes";
+    case metric_counter::random_bytes_calls:
+        return "random_bytes_calls";
+    case metric_counter::random_bytes:
+        return "random_bytes";
+    case metric_counter::reallocations:
+        return "reallocations";
+    case metric_counter::sequential_dispatches:
+        return "sequential_dispatches";
+    case metric_counter::parallel_dispatches:
+        return "parallel_dispatches";
+    case metric_counter::parallel_tasks:
+        return "parallel_tasks";
+    }
+    return "unknown";
+}
+
+std::string_view to_string_view(metric_phase phase)
+{
+    switch (phase)
+    {
+    case metric_phase::random_bytes_generation:
+        return "random_bytes_generation";
+    case metric_phase::keystream_construction:
+        return "keystream_construction";
+    case metric_phase::transform:
+        return "transform";
+    }
+    return "unknown";
+}
+
+namespace
+{
+std::atomic<metrics_sink*> metrics_sink_pointer = nullptr;
+}
+
+metrics_sink* current_metrics_sink()
+{
+    return metrics_sink_pointer.load(std::memory_order_acquire);
+}
+
+void set_metrics_sink(metrics_sink* sink)
+{
+    metrics_sink_pointer.store(sink, std::memory_order_release);
+}
+
+// histogram_metrics_sink
+
+void histogram_metrics_sink::add(metric_counter counter, uint64_t value)
+{
+    counters_[static_cast<std::size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+void histogram_metrics_sink::record(metric_phase phase, std::chrono::nanoseconds duration)
+{
+    const uint64_t nanoseconds = static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 1));
+    const std::size_t bucket_index = std::min<std::size_t>(std::bit_width(nanoseconds) - 1, bucket_count - 1);
+    histograms_[static_cast<std::size_t>(phase)][bucket_index].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t histogram_metrics_sink::counter(metric_counter counter) const
+{
+    return counters_[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+}
+
+histogram_metrics_sink::histogram histogram_metrics_sink::phase_histogram(metric_phase phase) const
+{
+    histogram result;
+    for (std::size_t i = 0; i < bucket_count; ++i)
+        result[i] = histograms_[static_cast<std::size_t>(phase)][i].load(std::memory_order_relaxed);
+    return result;
+}
+
+void histogram_metrics_sink::reset()
+{
+    for (std::atomic<uint64_t>& counter : counters_)
+        counter.store(0, std::memory_order_relaxed);
+    for (std::array<std::atomic<uint64_t>, bucket_count>& histogram : histograms_)
+        for (std::atomic<uint64_t>& bucket : histogram)
+            bucket.store(0, std::memory_order_relaxed);
+}
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,69 @@
+#include <arba/cryp/random_bytes.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <random>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+class random_bytes_buffer
+{
+public:
+    random_bytes_buffer() : engine_(make_engine_()) {}
+
+    void generate(std::span<uint8_t> bytes)
+    {
+        while (!bytes.empty())
+        {
+            if (position_ == buffer_.size())
+                refill_();
+            const std::size_t count = std::min(bytes.size(), buffer_.size() - position_);
+            std::memcpy(bytes.data(), buffer_.data() + position_, count);
+            position_ += count;
+            bytes = bytes.subspan(count);
+        }
+    }
+
+private:
+    // The whole state of the engine is seeded, not only 32 bits of it.
+    static std::mt19937_64 make_engine_()
+    {
+        std::random_device device;
+        std::array<std::random_device::result_type, std::mt19937_64::state_size * 2> seed_values;
+        std::ranges::generate(seed_values, std::ref(device));
+        std::seed_seq seed(seed_values.begin(), seed_values.end());
+        return std::mt19937_64(seed);
+    }
+
+    void refill_()
+    {
+        for (std::size_t i = 0; i < buffer_.size(); i += sizeof(uint64_t))
+        {
+            const uint64_t value = engine_();
+            std::memcpy(buffer_.data() + i, &value, sizeof(value));
+        }
+        position_ = 0;
+    }
+
+private:
+    std::mt19937_64 engine_;
+    std::array<uint8_t, 4096> buffer_;
+    std::size_t position_ = buffer_.size();
+};
+} // namespace
+
+void thread_local_random_bytes::operator()(std::span<uint8_t> bytes) const
+{
+    thread_local random_bytes_buffer buffer;
+    buffer.generate(bytes);
+}
+
+} // namespace cryp
+} // namespace arba
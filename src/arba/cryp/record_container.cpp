@@ -0,0 +1,316 @@
+#include <arba/cryp/byte_transform.hpp>
+#include <arba/cryp/key_schedule.hpp>
+#include <arba/cryp/keystream.hpp>
+#include <arba/cryp/metrics.hpp>
+#include <arba/cryp/record_container.hpp>
+#include <arba/cryp/symcrypt_range.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+using format = record_container_format;
+
+template <class Integer>
+void append_integer(std::vector<uint8_t>& bytes, Integer integer)
+{
+    for (std::size_t i = 0; i < sizeof(Integer); ++i, integer >>= 8)
+        bytes.push_back(static_cast<uint8_t>(integer));
+}
+
+template <class Integer>
+Integer load_integer(const std::byte* bytes)
+{
+    Integer integer = 0;
+    for (std::size_t i = sizeof(Integer); i-- > 0;)
+        integer = static_cast<Integer>((integer << 8) | static_cast<Integer>(bytes[i]));
+    return integer;
+}
+
+[[noreturn]] void throw_corrupted_segment()
+{
+    throw std::invalid_argument("record_reader: a segment is corrupted or encrypted with another key.");
+}
+
+// Bounds of the record local_index in a decrypted segment of record_count records, whose bytes are read by
+// read(offset, bytes).
+template <class ReadFunction>
+std::pair<std::size_t, std::size_t> record_bounds(std::size_t data_size, std::size_t record_count,
+                                                  std::size_t local_index, ReadFunction read)
+{
+    if (record_count > data_size / format::record_end_size) [[unlikely]]
+        throw_corrupted_segment();
+    const std::size_t ends_offset = data_size - record_count * format::record_end_size;
+    // The end of the previous record is the beginning of this one.
+    std::array<std::byte, 2 * format::record_end_size> end_bytes;
+    std::span<std::byte> ends = std::span(end_bytes).first(local_index > 0 ? 2 * format::record_end_size
+                                                                            : format::record_end_size);
+    read(ends_offset + (local_index + 1) * format::record_end_size - ends.size(), ends);
+    const std::size_t end = load_integer<uint32_t>(ends.data() + ends.size() - format::record_end_size);
+    const std::size_t begin = local_index > 0 ? load_integer<uint32_t>(ends.data()) : 0;
+    if (begin > end || end > ends_offset) [[unlikely]]
+        throw_corrupted_segment();
+    return { begin, end };
+}
+// Decrypts the bytes of a segment read by a record lookup, without building the keystream table of the segment: the
+// crypto offsets of the few bytes of a small record are computed one by one.
+class segment_lookup
+{
+public:
+    // The segment is at least symcrypt_base::min_encrypted_size bytes.
+    segment_lookup(const symcrypt_base& symcrypt, std::span<const std::byte> segment)
+        : schedule_(symcrypt.shared_key_schedule().get()), segment_(segment)
+    {
+        // The trailer is the size byte, then the offsets hidden with the key hash.
+        const std::span<const std::byte> trailer = segment_.last(symcrypt_base::trailer_size);
+        offsets_ = symcrypt_base::retrieve_offsets(*schedule_, trailer.last<keystream::offsets_size>());
+        data_size_ = symcrypt_base::decrypted_size(*schedule_, offsets_, trailer[0], segment_.size());
+    }
+
+    inline std::size_t data_size() const { return data_size_; }
+
+    // Decrypts the output.size() bytes of the segment starting at offset into output.
+    void decrypt(std::size_t offset, std::span<std::byte> output) const
+    {
+        const uint8_t* input = reinterpret_cast<const uint8_t*>(segment_.data() + offset);
+        uint8_t* output_bytes = reinterpret_cast<uint8_t*>(output.data());
+        // Beyond a period, the table costs less than the crypto offsets of the bytes.
+        if (output.size() >= keystream::period)
+        {
+            keystream(*schedule_, offsets_).decrypt(input, output_bytes, output.size(), offset);
+            return;
+        }
+        for (std::size_t i = 0; i < output.size(); ++i)
+            output_bytes[i] =
+                cryp::decrypt_byte(input[i], keystream::crypto_offset(*schedule_, offsets_, offset + i));
+    }
+
+private:
+    const key_schedule* schedule_;
+    std::span<const std::byte> segment_;
+    std::array<uint8_t, keystream::offsets_size> offsets_;
+    std::size_t data_size_;
+};
+} // namespace
+
+// writer
+
+record_writer::record_writer(symcrypt_base& symcrypt, chunk_sink sink, std::size_t records_per_segment,
+                             const execution_policy& policy)
+    : symcrypt_(&symcrypt), sink_(std::move(sink)), records_per_segment_(records_per_segment), policy_(policy)
+{
+    if (records_per_segment_ == 0) [[unlikely]]
+        throw std::invalid_argument("record_writer: the number of records per segment must not be 0.");
+    record_ends_.reserve(records_per_segment_);
+    sink_(format::magic);
+}
+
+std::size_t record_writer::append(std::span<const std::byte> record)
+{
+    if (is_finished_) [[unlikely]]
+        throw std::logic_error("record_writer: the container is finished.");
+    // The offsets of the records in the segment are 32-bit.
+    const std::size_t index_size = (record_ends_.size() + 1) * format::record_end_size;
+    if (record.size() > std::numeric_limits<uint32_t>::max() - index_size - segment_.size()) [[unlikely]]
+        throw std::length_error("record_writer: the segment is too large.");
+
+    const uint8_t* record_bytes = reinterpret_cast<const uint8_t*>(record.data());
+    segment_.insert(segment_.end(), record_bytes, record_bytes + record.size());
+    record_ends_.push_back(static_cast<uint32_t>(segment_.size()));
+    const std::size_t record_index = record_count_++;
+    if (record_ends_.size() == records_per_segment_)
+        write_segment_();
+    return record_index;
+}
+
+void record_writer::finish()
+{
+    if (is_finished_) [[unlikely]]
+        throw std::logic_error("record_writer: the container is already finished.");
+    if (!record_ends_.empty())
+        write_segment_();
+
+    std::vector<uint8_t> end_bytes;
+    end_bytes.reserve(segment_ends_.size() * sizeof(uint64_t) + format::footer_size);
+    for (uint64_t segment_end : segment_ends_)
+        append_integer(end_bytes, segment_end);
+    append_integer(end_bytes, static_cast<uint64_t>(records_per_segment_));
+    append_integer(end_bytes, static_cast<uint64_t>(record_count_));
+    const uint8_t* magic_bytes = reinterpret_cast<const uint8_t*>(format::magic.data());
+    end_bytes.insert(end_bytes.end(), magic_bytes, magic_bytes + format::magic.size());
+    sink_(std::as_bytes(std::span(end_bytes)));
+    is_finished_ = true;
+}
+
+void record_writer::write_segment_()
+{
+    for (uint32_t record_end : record_ends_)
+        append_integer(segment_, record_end);
+    // The segment buffer keeps its capacity from one segment to the next.
+    symcrypt_->encrypt(segment_, policy_);
+    sink_(std::as_bytes(std::span(segment_)));
+    const uint64_t segment_begin = segment_ends_.empty() ? format::magic.size() : segment_ends_.back();
+    segment_ends_.push_back(segment_begin + segment_.size());
+    segment_.clear();
+    record_ends_.clear();
+}
+
+// reader
+
+record_reader::record_reader(const symcrypt_base& symcrypt, std::span<const std::byte> container)
+    : symcrypt_(&symcrypt), container_(container)
+{
+    constexpr std::size_t min_container_size = format::magic.size() + format::footer_size;
+    if (container_.size() < min_container_size
+        || !std::ranges::equal(container_.first(format::magic.size()), format::magic)
+        || !std::ranges::equal(container_.last(format::magic.size()), format::magic)) [[unlikely]]
+        throw std::invalid_argument("record_reader: the data are not a record container.");
+
+    const std::byte* footer = container_.data() + container_.size() - format::footer_size;
+    const uint64_t records_per_segment = load_integer<uint64_t>(footer);
+    const uint64_t record_count = load_integer<uint64_t>(footer + sizeof(uint64_t));
+    if (records_per_segment == 0) [[unlikely]]
+        throw std::invalid_argument("record_reader: the record container is corrupted.");
+    const uint64_t segment_count = record_count / records_per_segment + (record_count % records_per_segment != 0);
+    // Each segment has an end in the container.
+    if (segment_count > (container_.size() - min_container_size) / sizeof(uint64_t)) [[unlikely]]
+        throw std::invalid_argument("record_reader: the record container is corrupted.");
+    records_per_segment_ = static_cast<std::size_t>(records_per_segment);
+    record_count_ = static_cast<std::size_t>(record_count);
+
+    const std::size_t segment_ends_offset = container_.size() - format::footer_size - segment_count * sizeof(uint64_t);
+    segment_ends_.reserve(segment_count);
+    std::size_t segment_begin = format::magic.size();
+    for (std::size_t i = 0; i < segment_count; ++i)
+    {
+        const uint64_t segment_end =
+            load_integer<uint64_t>(container_.data() + segment_ends_offset + i * sizeof(uint64_t));
+        bool is_valid = segment_end <= segment_ends_offset && segment_end >= segment_begin
+                        && segment_end - segment_begin >= symcrypt_base::min_encrypted_size;
+        // The segment must be large enough for the index of its records. As segment_count is rounded up, the last
+        // segment has at least one record.
+        const std::size_t first_record_index = i * records_per_segment_;
+        const std::size_t segment_record_count = std::min(records_per_segment_, record_count_ - first_record_index);
+        is_valid = is_valid && segment_record_count <= (segment_end - segment_begin - symcrypt_base::trailer_size)
+                                                           / format::record_end_size;
+        if (!is_valid) [[unlikely]]
+            throw std::invalid_argument("record_reader: the record container is corrupted.");
+        segment_begin = static_cast<std::size_t>(segment_end);
+        segment_ends_.push_back(segment_begin);
+    }
+    if (segment_begin != segment_ends_offset) [[unlikely]]
+        throw std::invalid_argument("record_reader: the record container is corrupted.");
+}
+
+template <class RecordFunction>
+auto record_reader::visit_record_(std::size_t record_index, RecordFunction function) const
+{
+    const record_location location = locate_(record_index);
+    const segment_lookup lookup(*symcrypt_, segment_bytes_(location.segment_index));
+    // Only the index entries of the record are decrypted to find it.
+    const auto [begin, end] =
+        record_bounds(lookup.data_size(), location.record_count, record_index - location.first_record_index,
+                      [&](std::size_t offset, std::span<std::byte> bytes) { lookup.decrypt(offset, bytes); });
+    return function(lookup, begin, end - begin);
+}
+
+std::size_t record_reader::record_size(std::size_t record_index) const
+{
+    return visit_record_(record_index, [](const auto&, std::size_t, std::size_t size) { return size; });
+}
+
+std::size_t record_reader::read_record(std::size_t record_index, std::span<std::byte> output) const
+{
+    return visit_record_(record_index,
+                         [&](const auto& lookup, std::size_t offset, std::size_t size)
+                         {
+                             if (output.size() < size) [[unlikely]]
+                                 throw std::invalid_argument("record_reader: output is too small.");
+                             lookup.decrypt(offset, output.first(size));
+                             return size;
+                         });
+}
+
+std::vector<std::byte> record_reader::record(std::size_t record_index) const
+{
+    return visit_record_(record_index,
+                         [](const auto& lookup, std::size_t offset, std::size_t size)
+                         {
+                             std::vector<std::byte> bytes(size);
+                             lookup.decrypt(offset, bytes);
+                             return bytes;
+                         });
+}
+
+void record_reader::for_each_record(const record_function& function, const execution_policy& policy) const
+{
+    const auto decode_segments = [&](std::size_t first_segment, std::size_t last_segment)
+    {
+        // The buffer of the decrypted segments is reused from one segment to the next.
+        std::vector<std::byte> segment_data;
+        for (std::size_t segment_index = first_segment; segment_index < last_segment; ++segment_index)
+        {
+            const std::span<const std::byte> segment = segment_bytes_(segment_index);
+            const symcrypt_range_decryptor decryptor(*symcrypt_, segment.last<symcrypt_base::trailer_size>(),
+                                                     segment.size());
+            segment_data.resize(decryptor.data_size());
+            decryptor.decrypt_range(0, segment.first(segment_data.size()), segment_data);
+
+            const std::size_t first_record_index = segment_index * records_per_segment_;
+            const std::size_t record_count = std::min(records_per_segment_, record_count_ - first_record_index);
+            for (std::size_t local_index = 0; local_index < record_count; ++local_index)
+            {
+                const auto [begin, end] = record_bounds(
+                    segment_data.size(), record_count, local_index, [&](std::size_t offset, std::span<std::byte> bytes)
+                    { std::ranges::copy(std::span(segment_data).subspan(offset, bytes.size()), bytes.begin()); });
+                function(first_record_index + local_index, std::span(segment_data).subspan(begin, end - begin));
+            }
+        }
+    };
+
+    const std::size_t segment_count = segment_ends_.size();
+    const std::size_t task_count = std::min(policy.thread_count(container_.size()), segment_count);
+    if (task_count <= 1)
+    {
+        add_metric(metric_counter::sequential_dispatches);
+        decode_segments(0, segment_count);
+        return;
+    }
+
+    add_metric(metric_counter::parallel_dispatches);
+    add_metric(metric_counter::parallel_tasks, task_count);
+    // Each task decodes a contiguous range of segments, so that no more than task_count threads are used.
+    symcrypt_->parallel_executor().bulk_execute(task_count,
+                                                [&](std::size_t task_index)
+                                                {
+                                                    decode_segments(segment_count * task_index / task_count,
+                                                                    segment_count * (task_index + 1) / task_count);
+                                                });
+}
+
+record_reader::record_location record_reader::locate_(std::size_t record_index) const
+{
+    if (record_index >= record_count_) [[unlikely]]
+        throw std::out_of_range("record_reader: the record index is out of range.");
+    const std::size_t segment_index = record_index / records_per_segment_;
+    const std::size_t first_record_index = segment_index * records_per_segment_;
+    return record_location{ segment_index, first_record_index,
+                            std::min(records_per_segment_, record_count_ - first_record_index) };
+}
+
+std::span<const std::byte> record_reader::segment_bytes_(std::size_t segment_index) const
+{
+    const std::size_t segment_begin = segment_index > 0 ? segment_ends_[segment_index - 1] : format::magic.size();
+    return container_.subspan(segment_begin, segment_ends_[segment_index] - segment_begin);
+}
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,710 @@
+#include <arba/cryp/byte_transform.hpp>
+#include <arba/cryp/metrics.hpp>
+#include <arba/cryp/symcrypt_base.hpp>
+
+#include <arba/hash/murmur_hash.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+// Parallel tasks work on blocks which are a multiple of the keystream period (so that each block starts at the
+// beginning of the keystream), and small enough to stay in cache.
+constexpr std::size_t parallel_block_size = keystream::period * 28;
+
+// Little-endian storage of the checksums.
+void store_uint64(uint64_t integer, uint8_t* bytes)
+{
+    for (std::size_t i = 0; i < sizeof(uint64_t); ++i, integer >>= 8)
+        bytes[i] = static_cast<uint8_t>(integer);
+}
+
+uint64_t load_uint64(const uint8_t* bytes)
+{
+    uint64_t integer = 0;
+    for (std::size_t i = sizeof(uint64_t); i-- > 0;)
+        integer = (integer << 8) | bytes[i];
+    return integer;
+}
+
+// The first byte of input is the byte first_index of the message.
+// transform(input, output, size, first_index) transforms a range of bytes with the keystream(s) of the message.
+// The ranges of the parallel tasks start at the beginning of a block of block_size bytes.
+template <class TransformFunction>
+void transform_blocks(const uint8_t* input, uint8_t* output, std::size_t size, std::size_t first_index,
+                      std::size_t block_size, const execution_policy& policy, executor& exec,
+                      TransformFunction transform)
+{
+    const std::size_t block_count = (size + block_size - 1) / block_size;
+    const std::size_t task_count = std::min(policy.thread_count(size), block_count);
+    scoped_phase_timer timer(metric_phase::transform);
+    if (task_count <= 1)
+    {
+        add_metric(metric_counter::sequential_dispatches);
+        transform(input, output, size, first_index);
+        return;
+    }
+
+    add_metric(metric_counter::parallel_dispatches);
+    add_metric(metric_counter::parallel_tasks, task_count);
+    // Each task transforms a contiguous range of blocks, so that no more than task_count threads are used.
+    exec.bulk_execute(task_count,
+                      [&](std::size_t task_index)
+                      {
+                          const std::size_t first_block = block_count * task_index / task_count;
+                          const std::size_t last_block = block_count * (task_index + 1) / task_count;
+                          const std::size_t first_byte = first_block * block_size;
+                          const std::size_t last_byte = std::min(last_block * block_size, size);
+                          transform(input + first_byte, output + first_byte, last_byte - first_byte,
+                                    first_index + first_byte);
+                      });
+}
+
+template <class TransformFunction>
+void transform_seq(const uint8_t* input, uint8_t* output, std::size_t size, std::size_t first_index,
+                   const execution_policy& policy, executor& exec, TransformFunction transform)
+{
+    transform_blocks(input, output, size, first_index, parallel_block_size, policy, exec, transform);
+}
+
+// The data are checked by blocks of symcrypt_base::checksum_block_size bytes, each block having its own checksum, so
+// that the blocks can be checked by the parallel tasks. check_block(block_index, block) is called on the plaintext of
+// each block while it is in cache, just before its encryption or just after its decryption. The tasks stop at the
+// first block for which it returns false, and false is returned.
+template <class TransformFunction, class CheckFunction>
+bool checked_transform_seq(const uint8_t* input, uint8_t* output, std::size_t size, bool plaintext_is_input,
+                           const execution_policy& policy, executor& exec, TransformFunction transform,
+                           CheckFunction check_block)
+{
+    constexpr std::size_t checksum_block_size = symcrypt_base::checksum_block_size;
+    // Empty data have the checksum of an empty block.
+    if (size == 0)
+        return check_block(0, std::span<const uint8_t>());
+    std::atomic_bool is_valid = true;
+    transform_blocks(input, output, size, 0, checksum_block_size, policy, exec,
+                     [&](const uint8_t* in, uint8_t* out, std::size_t count, std::size_t index)
+                     {
+                         for (std::size_t offset = 0; offset < count && is_valid.load(std::memory_order_relaxed);
+                              offset += checksum_block_size)
+                         {
+                             const std::size_t block_size = std::min(checksum_block_size, count - offset);
+                             const std::size_t block_index = (index + offset) / checksum_block_size;
+                             if (plaintext_is_input)
+                                 check_block(block_index, std::span(in + offset, block_size));
+                             transform(in + offset, out + offset, block_size, index + offset);
+                             if (!plaintext_is_input && !check_block(block_index, std::span(out + offset, block_size)))
+                                 is_valid.store(false, std::memory_order_relaxed);
+                         }
+                     });
+    return is_valid.load();
+}
+
+keystream make_keystream(const key_schedule& schedule, keystream::offsets_span offs, std::size_t length)
+{
+    scoped_phase_timer timer(metric_phase::keystream_construction);
+    return keystream(schedule, offs, length);
+}
+
+// Splits the messages of a batch into contiguous ranges, one per task.
+template <class RangeFunction>
+void for_each_message_range(std::size_t message_count, std::size_t thread_count, executor& exec,
+                            RangeFunction range_function)
+{
+    const std::size_t task_count = std::min(thread_count, message_count);
+    if (task_count <= 1)
+    {
+        add_metric(metric_counter::sequential_dispatches);
+        range_function(0, message_count);
+        return;
+    }
+
+    add_metric(metric_counter::parallel_dispatches);
+    add_metric(metric_counter::parallel_tasks, task_count);
+
+    exec.bulk_execute(task_count,
+                      [&](std::size_t task_index)
+                      {
+                          range_function(message_count * task_index / task_count,
+                                         message_count * (task_index + 1) / task_count);
+                      });
+}
+
+uint8_t* to_uint8_pointer(std::byte* bytes)
+{
+    return reinterpret_cast<uint8_t*>(bytes);
+}
+
+const uint8_t* to_uint8_pointer(const std::byte* bytes)
+{
+    return reinterpret_cast<const uint8_t*>(bytes);
+}
+} // namespace
+
+symcrypt_base::symcrypt_base(const crypto_key& key) : key_schedule_(std::make_shared<const key_schedule>(key))
+{
+}
+
+symcrypt_base::symcrypt_base(const std::string_view& key) : symcrypt_base(to_crypto_key(key))
+{
+}
+
+symcrypt_base::symcrypt_base(std::shared_ptr<const key_schedule> schedule)
+{
+    set_key_schedule(std::move(schedule));
+}
+
+void symcrypt_base::set_key(const crypto_key& key)
+{
+    key_schedule_ = std::make_shared<const key_schedule>(key);
+}
+
+void symcrypt_base::set_key(const std::string_view& key)
+{
+    set_key(to_crypto_key(key));
+}
+
+void symcrypt_base::set_key_schedule(std::shared_ptr<const key_schedule> schedule)
+{
+    if (!schedule) [[unlikely]]
+        throw std::invalid_argument("symcrypt: the key schedule is null.");
+    key_schedule_ = std::move(schedule);
+}
+
+symcrypt_base::crypto_key symcrypt_base::to_crypto_key(const std::string_view& key)
+{
+    return crypto_key(hash::neutral_murmur_hash_array_16(key.data(), key.length()));
+}
+
+void symcrypt_base::encrypt(std::vector<uint8_t>& bytes, const execution_policy& policy)
+{
+    encrypt<std::allocator<uint8_t>>(bytes, policy);
+}
+
+void symcrypt_base::decrypt(std::vector<uint8_t>& bytes, const execution_policy& policy)
+{
+    decrypt<std::allocator<uint8_t>>(bytes, policy);
+}
+
+std::size_t symcrypt_base::decrypted_size(std::span<const std::byte> encrypted_bytes) const
+{
+    if (encrypted_bytes.size() < min_encrypted_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: encrypted data are too small.");
+    const uint8_t* input = to_uint8_pointer(encrypted_bytes.data());
+    const std::size_t body_size = encrypted_bytes.size() - std::tuple_size_v<offsets>;
+    offsets offs;
+    decrypt_and_retrieves_offsets_(*key_schedule_, input + body_size, offs);
+    return decrypted_size(*key_schedule_, offs, encrypted_bytes[body_size - 1], encrypted_bytes.size());
+}
+
+std::size_t symcrypt_base::encrypt(std::span<const std::byte> input, std::span<std::byte> output,
+                                   const execution_policy& policy)
+{
+    const std::size_t output_size = encrypted_size(input.size());
+    if (output.size() < output_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: output is too small.");
+    encrypt_(to_uint8_pointer(input.data()), input.size(), to_uint8_pointer(output.data()), policy);
+    return output_size;
+}
+
+std::size_t symcrypt_base::encrypt(std::span<const std::byte> input, std::span<std::byte> output,
+                                   const random_bytes_array& random_bytes, const execution_policy& policy) const
+{
+    const std::size_t output_size = encrypted_size(input.size());
+    if (output.size() < output_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: output is too small.");
+    encrypt_(to_uint8_pointer(input.data()), input.size(), to_uint8_pointer(output.data()), random_bytes.data(),
+             policy);
+    return output_size;
+}
+
+keystream symcrypt_base::encrypt_trailer(std::size_t data_size, const random_bytes_array& random_bytes,
+                                         std::span<std::byte> trailer) const
+{
+    if (trailer.size() < scattered_trailer_size(data_size)) [[unlikely]]
+        throw std::invalid_argument("symcrypt: trailer is too small.");
+    const offsets offs = random_offsets_(random_bytes.data(), data_size);
+    keystream kstream(*key_schedule_, offs);
+    encrypt_trailer_(to_uint8_pointer(trailer.data()), data_size, random_bytes.data(), offs, kstream);
+    return kstream;
+}
+
+std::size_t symcrypt_base::decrypt(std::span<const std::byte> input, std::span<std::byte> output,
+                                   const execution_policy& policy)
+{
+    if (output.size() < decrypted_size(input)) [[unlikely]]
+        throw std::invalid_argument("symcrypt: output is too small.");
+    return decrypt_(to_uint8_pointer(input.data()), input.size(), to_uint8_pointer(output.data()), policy);
+}
+
+void symcrypt_base::draw_random_bytes(std::span<uint8_t> bytes)
+{
+    {
+        scoped_phase_timer timer(metric_phase::random_bytes_generation);
+        generate_random_bytes_(bytes);
+    }
+    add_metric(metric_counter::random_bytes_calls);
+    add_metric(metric_counter::random_bytes, bytes.size());
+}
+
+std::array<uint8_t, keystream::offsets_size>
+symcrypt_base::retrieve_offsets(const key_schedule& schedule,
+                                std::span<const std::byte, keystream::offsets_size> encrypted_offsets)
+{
+    offsets offs;
+    decrypt_and_retrieves_offsets_(schedule, to_uint8_pointer(encrypted_offsets.data()), offs);
+    return offs;
+}
+
+std::size_t symcrypt_base::decrypted_size(const key_schedule& schedule, keystream::offsets_span offs,
+                                          std::byte encrypted_size_byte, std::size_t encrypted_size)
+{
+    // The size byte is the last byte before the offsets.
+    const std::size_t body_size = encrypted_size - std::tuple_size_v<offsets>;
+    const uint8_t crypto_offset = keystream::crypto_offset(schedule, offs, body_size - 1);
+    return decrypted_size_(encrypted_size, decrypt_byte(static_cast<uint8_t>(encrypted_size_byte), crypto_offset));
+}
+
+std::size_t symcrypt_base::encrypt_in_place(std::span<std::byte> buffer, std::size_t data_size,
+                                            const execution_policy& policy)
+{
+    const std::size_t output_size = encrypted_size(data_size);
+    if (buffer.size() < output_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: buffer is too small.");
+    uint8_t* bytes = to_uint8_pointer(buffer.data());
+    encrypt_(bytes, data_size, bytes, policy);
+    return output_size;
+}
+
+std::size_t symcrypt_base::decrypt_in_place(std::span<std::byte> buffer, const execution_policy& policy)
+{
+    if (buffer.size() < min_encrypted_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: encrypted data are too small.");
+    uint8_t* bytes = to_uint8_pointer(buffer.data());
+    return decrypt_(bytes, buffer.size(), bytes, policy);
+}
+
+std::size_t symcrypt_base::encrypt_scattered(std::span<const std::span<std::byte>> fragments,
+                                             std::span<std::byte> trailer, const execution_policy& policy)
+{
+    std::size_t data_size = 0;
+    for (std::span<std::byte> fragment : fragments)
+        data_size += fragment.size();
+    const std::size_t trailer_output_size = scattered_trailer_size(data_size);
+    if (trailer.size() < trailer_output_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: trailer is too small.");
+
+    const random_bytes_array random_bytes = draw_random_bytes(data_size);
+    const offsets offs = random_offsets_(random_bytes.data(), data_size);
+
+    // The fragments are encrypted as parts of one message, the trailer being its end.
+    add_metric(metric_counter::encrypt_calls);
+    add_metric(metric_counter::encrypted_bytes, data_size);
+    const std::size_t body_size = std::max<std::size_t>(data_size, min_data_size) + 1;
+    const keystream kstream = make_keystream(*key_schedule_, offs, body_size);
+    std::size_t byte_index = 0;
+    for (std::span<std::byte> fragment : fragments)
+    {
+        uint8_t* bytes = to_uint8_pointer(fragment.data());
+        encrypt_seq_(bytes, bytes, fragment.size(), kstream, policy, byte_index);
+        byte_index += fragment.size();
+    }
+    encrypt_trailer_(to_uint8_pointer(trailer.data()), data_size, random_bytes.data(), offs, kstream);
+    return trailer_output_size;
+}
+
+std::size_t symcrypt_base::decrypt_scattered(std::span<const std::span<std::byte>> fragments,
+                                             const execution_policy& policy)
+{
+    std::size_t encrypted_size = 0;
+    for (std::span<std::byte> fragment : fragments)
+        encrypted_size += fragment.size();
+    if (encrypted_size < min_encrypted_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: encrypted data are too small.");
+
+    // The size byte and the offsets may be split between the last fragments.
+    std::array<uint8_t, trailer_size> tail;
+    std::size_t tail_size = 0;
+    for (auto iter = fragments.rbegin(); iter != fragments.rend() && tail_size < tail.size(); ++iter)
+    {
+        const std::size_t copy_size = std::min(iter->size(), tail.size() - tail_size);
+        tail_size += copy_size;
+        std::ranges::copy(iter->last(copy_size), reinterpret_cast<std::byte*>(tail.end() - tail_size));
+    }
+    offsets offs;
+    decrypt_and_retrieves_offsets_(*key_schedule_, tail.data() + 1, offs);
+
+    const std::size_t body_size = encrypted_size - std::tuple_size_v<offsets>;
+    const keystream kstream = make_keystream(*key_schedule_, offs, body_size);
+    const uint8_t size_byte = decrypt_byte(tail.front(), kstream[body_size - 1]);
+    const std::size_t data_size = decrypted_size_(encrypted_size, size_byte);
+    add_metric(metric_counter::decrypt_calls);
+    add_metric(metric_counter::decrypted_bytes, data_size);
+    std::size_t byte_index = 0;
+    for (std::span<std::byte> fragment : fragments)
+    {
+        if (byte_index >= data_size)
+            break;
+        uint8_t* bytes = to_uint8_pointer(fragment.data());
+        const std::size_t size = std::min(fragment.size(), data_size - byte_index);
+        decrypt_seq_(bytes, bytes, size, kstream, policy, byte_index);
+        byte_index += size;
+    }
+    return data_size;
+}
+
+std::size_t symcrypt_base::encrypt_checked(std::span<const std::byte> input, std::span<std::byte> output,
+                                           const execution_policy& policy)
+{
+    const std::size_t data_size = input.size();
+    const std::size_t output_size = checked_encrypted_size(data_size);
+    if (output.size() < output_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: output is too small.");
+
+    // The checksums are encrypted as the end of the message.
+    const std::size_t checksums_size = checksum_count(data_size) * checksum_size;
+    const std::size_t message_size = data_size + checksums_size;
+    const random_bytes_array random_bytes = draw_random_bytes(message_size);
+    const offsets offs = random_offsets_(random_bytes.data(), message_size);
+    add_metric(metric_counter::encrypt_calls);
+    add_metric(metric_counter::encrypted_bytes, data_size);
+    const std::size_t body_size = std::max<std::size_t>(message_size, min_data_size) + 1;
+    const keystream kstream = make_keystream(*key_schedule_, offs, body_size);
+    uint8_t* bytes = to_uint8_pointer(output.data());
+    uint8_t* checksums = bytes + data_size;
+    checked_transform_seq(to_uint8_pointer(input.data()), bytes, data_size, true, policy, parallel_executor(),
+                          [&kstream](const uint8_t* in, uint8_t* out, std::size_t count, std::size_t index)
+                          { kstream.encrypt(in, out, count, index); },
+                          [checksums](std::size_t block_index, std::span<const uint8_t> block)
+                          {
+                              store_uint64(hash::neutral_murmur_hash_64(block.data(), block.size()),
+                                           checksums + block_index * checksum_size);
+                              return true;
+                          });
+    kstream.encrypt(checksums, checksums, checksums_size, data_size);
+    encrypt_trailer_(bytes + message_size, message_size, random_bytes.data(), offs, kstream);
+    return output_size;
+}
+
+std::size_t symcrypt_base::decrypt_checked(std::span<const std::byte> input, std::span<std::byte> output,
+                                           const execution_policy& policy)
+{
+    if (input.size() < min_encrypted_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: encrypted data are too small.");
+    const uint8_t* bytes = to_uint8_pointer(input.data());
+    const std::size_t body_size = input.size() - std::tuple_size_v<offsets>;
+    offsets offs;
+    decrypt_and_retrieves_offsets_(*key_schedule_, bytes + body_size, offs);
+    const keystream kstream = make_keystream(*key_schedule_, offs, body_size);
+    const uint8_t size_byte = decrypt_byte(bytes[body_size - 1], kstream[body_size - 1]);
+    const std::size_t message_size = decrypted_size_(input.size(), size_byte);
+    // The message is the data followed by one checksum per block of data.
+    const std::size_t block_count =
+        (message_size + checksum_block_size + checksum_size - 1) / (checksum_block_size + checksum_size);
+    if (message_size < block_count * checksum_size
+        || checksum_count(message_size - block_count * checksum_size) != block_count) [[unlikely]]
+        throw std::invalid_argument("symcrypt: encrypted data have no checksum.");
+    const std::size_t data_size = message_size - block_count * checksum_size;
+    if (output.size() < data_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: output is too small.");
+
+    // The checksums are read before output is written, as input and output may be the same sequence.
+    std::vector<uint8_t> expected_checksums(block_count * checksum_size);
+    kstream.decrypt(bytes + data_size, expected_checksums.data(), expected_checksums.size(), data_size);
+    add_metric(metric_counter::decrypt_calls);
+    add_metric(metric_counter::decrypted_bytes, data_size);
+    // Each block is written by one task only.
+    std::vector<uint8_t> decrypted_blocks(block_count, false);
+    uint8_t* output_bytes = to_uint8_pointer(output.data());
+    const bool is_valid = checked_transform_seq(
+        bytes, output_bytes, data_size, false, policy, parallel_executor(),
+        [&kstream](const uint8_t* in, uint8_t* out, std::size_t count, std::size_t index)
+        { kstream.decrypt(in, out, count, index); },
+        [&](std::size_t block_index, std::span<const uint8_t> block)
+        {
+            decrypted_blocks[block_index] = true;
+            return hash::neutral_murmur_hash_64(block.data(), block.size())
+                   == load_uint64(&expected_checksums[block_index * checksum_size]);
+        });
+    if (!is_valid) [[unlikely]]
+    {
+        // No unverified data are left in output: decrypted in place, the decrypted blocks are encrypted back.
+        if (output_bytes == bytes)
+        {
+            for (std::size_t block_index = 0; block_index < block_count; ++block_index)
+            {
+                const std::size_t offset = block_index * checksum_block_size;
+                if (decrypted_blocks[block_index])
+                    kstream.encrypt(output_bytes + offset, output_bytes + offset,
+                                    std::min(checksum_block_size, data_size - offset), offset);
+            }
+        }
+        else
+            std::ranges::fill(output.first(data_size), std::byte(0));
+        throw std::invalid_argument("symcrypt: the checksum of a block of the decrypted data does not match.");
+    }
+    return data_size;
+}
+
+void symcrypt_base::encrypt_checked(std::vector<uint8_t>& bytes, const execution_policy& policy)
+{
+    const std::size_t data_size = bytes.size();
+    if (bytes.capacity() < checked_encrypted_size(data_size))
+        add_metric(metric_counter::reallocations);
+    bytes.resize(checked_encrypted_size(data_size));
+    std::span<std::byte> buffer = std::as_writable_bytes(std::span(bytes));
+    encrypt_checked(buffer.first(data_size), buffer, policy);
+}
+
+void symcrypt_base::decrypt_checked(std::vector<uint8_t>& bytes, const execution_policy& policy)
+{
+    std::span<std::byte> buffer = std::as_writable_bytes(std::span(bytes));
+    bytes.resize(decrypt_checked(buffer, buffer, policy));
+}
+
+void symcrypt_base::reencrypt(const key_schedule& old_schedule, std::span<std::byte> encrypted_bytes,
+                              const execution_policy& policy)
+{
+    if (encrypted_bytes.size() < min_encrypted_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: encrypted data are too small.");
+    uint8_t* bytes = to_uint8_pointer(encrypted_bytes.data());
+    const std::size_t body_size = encrypted_bytes.size() - std::tuple_size_v<offsets>;
+
+    // The old offsets are retrieved with the old key hash.
+    offsets old_offs;
+    decrypt_and_retrieves_offsets_(old_schedule, bytes + body_size, old_offs);
+    const keystream old_kstream = make_keystream(old_schedule, old_offs, body_size);
+
+    // Only new offsets are drawn: the padding bytes stay random once encrypted with the new keystream.
+    offsets new_offs;
+    draw_random_bytes(new_offs);
+    const keystream new_kstream = make_keystream(*key_schedule_, new_offs, body_size);
+
+    // Data, padding and size byte are decrypted and encrypted again in one pass.
+    transform_seq(bytes, bytes, body_size, 0, policy, parallel_executor(),
+                  [&](const uint8_t* in, uint8_t* out, std::size_t count, std::size_t index)
+                  { old_kstream.reencrypt(new_kstream, in, out, count, index); });
+    encrypt_and_stores_offsets_(bytes + body_size, new_offs);
+}
+
+void symcrypt_base::reencrypt(const crypto_key& old_key, std::span<std::byte> encrypted_bytes,
+                              const execution_policy& policy)
+{
+    reencrypt(key_schedule(old_key), encrypted_bytes, policy);
+}
+
+void symcrypt_base::reencrypt(const crypto_key& old_key, std::vector<uint8_t>& bytes, const execution_policy& policy)
+{
+    reencrypt(old_key, std::as_writable_bytes(std::span(bytes)), policy);
+}
+
+std::size_t symcrypt_base::encrypted_batch_size(std::span<const std::span<const std::byte>> messages)
+{
+    std::size_t size = 0;
+    for (std::span<const std::byte> message : messages)
+        size += encrypted_size(message.size());
+    return size;
+}
+
+std::size_t symcrypt_base::decrypted_batch_size(std::span<const std::span<const std::byte>> encrypted_messages) const
+{
+    std::size_t size = 0;
+    for (std::span<const std::byte> encrypted_message : encrypted_messages)
+        size += decrypted_size(encrypted_message);
+    return size;
+}
+
+std::size_t symcrypt_base::encrypt_batch(std::span<const std::span<const std::byte>> messages,
+                                         std::span<std::byte> output, const execution_policy& policy)
+{
+    std::size_t output_size = 0;
+    std::size_t random_bytes_size = 0;
+    for (std::span<const std::byte> message : messages)
+    {
+        output_size += encrypted_size(message.size());
+        random_bytes_size += random_bytes_size_(message.size());
+    }
+    if (output.size() < output_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: output is too small.");
+
+    std::vector<uint8_t> random_bytes(random_bytes_size);
+    draw_random_bytes(random_bytes);
+    for_each_message_range(
+        messages.size(), policy.thread_count(output_size), parallel_executor(),
+        [&](std::size_t first_message, std::size_t last_message)
+        {
+            // Positions of the first message of the range, in output and in random_bytes.
+            std::size_t output_index = 0;
+            std::size_t random_bytes_index = 0;
+            for (std::span<const std::byte> message : messages.first(first_message))
+            {
+                output_index += encrypted_size(message.size());
+                random_bytes_index += random_bytes_size_(message.size());
+            }
+            for (std::span<const std::byte> message : messages.subspan(first_message, last_message - first_message))
+            {
+                encrypt_(to_uint8_pointer(message.data()), message.size(),
+                         to_uint8_pointer(output.data() + output_index), &random_bytes[random_bytes_index],
+                         execution_policy::sequential());
+                output_index += encrypted_size(message.size());
+                random_bytes_index += random_bytes_size_(message.size());
+            }
+        });
+    return output_size;
+}
+
+std::size_t symcrypt_base::decrypt_batch(std::span<const std::span<const std::byte>> encrypted_messages,
+                                         std::span<std::byte> output, std::span<std::size_t> message_sizes,
+                                         const execution_policy& policy)
+{
+    if (message_sizes.size() < encrypted_messages.size()) [[unlikely]]
+        throw std::invalid_argument("symcrypt: message_sizes is too small.");
+    std::size_t output_size = 0;
+    for (std::size_t i = 0; i < encrypted_messages.size(); ++i)
+    {
+        message_sizes[i] = decrypted_size(encrypted_messages[i]);
+        output_size += message_sizes[i];
+    }
+    if (output.size() < output_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: output is too small.");
+
+    for_each_message_range(encrypted_messages.size(), policy.thread_count(output_size), parallel_executor(),
+                           [&](std::size_t first_message, std::size_t last_message)
+                           {
+                               std::size_t output_index = 0;
+                               for (std::size_t i = 0; i < first_message; ++i)
+                                   output_index += message_sizes[i];
+                               for (std::size_t i = first_message; i < last_message; ++i)
+                               {
+                                   std::span<const std::byte> encrypted_message = encrypted_messages[i];
+                                   decrypt_(to_uint8_pointer(encrypted_message.data()), encrypted_message.size(),
+                                            to_uint8_pointer(output.data() + output_index),
+                                            execution_policy::sequential());
+                                   output_index += message_sizes[i];
+                               }
+                           });
+    return output_size;
+}
+
+// encrypt/decrypt data
+void symcrypt_base::encrypt_(const uint8_t* input, std::size_t data_size, uint8_t* output,
+                             const execution_policy& policy)
+{
+    const random_bytes_array random_bytes = draw_random_bytes(data_size);
+    encrypt_(input, data_size, output, random_bytes.data(), policy);
+}
+
+symcrypt_base::random_bytes_array symcrypt_base::draw_random_bytes(std::size_t data_size)
+{
+    // The random padding bytes and offsets are generated in one call.
+    random_bytes_array random_bytes;
+    draw_random_bytes(std::span(random_bytes.data(), random_bytes_size_(data_size)));
+    return random_bytes;
+}
+
+void symcrypt_base::encrypt_(const uint8_t* input, std::size_t data_size, uint8_t* output,
+                             const uint8_t* random_bytes, const execution_policy& policy) const
+{
+    // Get offsets randomly so that twice encryption of the
+    // same data do not generate the same byte sequence.
+    const offsets offs = random_offsets_(random_bytes, data_size);
+
+    // Encrypt the byte sequence.
+    add_metric(metric_counter::encrypt_calls);
+    add_metric(metric_counter::encrypted_bytes, data_size);
+    const std::size_t body_size = std::max<std::size_t>(data_size, min_data_size) + 1;
+    const keystream kstream = make_keystream(*key_schedule_, offs, body_size);
+    encrypt_seq_(input, output, data_size, kstream, policy);
+    encrypt_trailer_(output + data_size, data_size, random_bytes, offs, kstream);
+}
+
+void symcrypt_base::encrypt_trailer_(uint8_t* tail, std::size_t data_size, const uint8_t* random_bytes,
+                                     const offsets& offs, const keystream& kstream) const
+{
+    // The data are padded so that empty or very small data cannot be guessed,
+    // and size information is stored at the end of data.
+    const std::size_t padding_size = random_bytes_size_(data_size) - std::tuple_size_v<offsets>;
+    std::ranges::copy_n(random_bytes, padding_size, tail);
+    tail[padding_size] = data_size <= min_data_size ? static_cast<uint8_t>(data_size) : min_data_size_1;
+    kstream.encrypt(tail, tail, padding_size + 1, data_size);
+    // The offsets must be appended to the generated byte sequence
+    // as it cannot be guessed by the decrypter.
+    encrypt_and_stores_offsets_(tail + padding_size + 1, offs);
+}
+
+std::size_t symcrypt_base::decrypt_(const uint8_t* input, std::size_t encrypted_size, uint8_t* output,
+                                    const execution_policy& policy)
+{
+    // Get the offsets, stored after the byte sequence to decrypt.
+    const std::size_t body_size = encrypted_size - std::tuple_size_v<offsets>;
+    offsets offs;
+    decrypt_and_retrieves_offsets_(*key_schedule_, input + body_size, offs);
+    // Size information is retrieved, and only the data are decrypted.
+    const keystream kstream = make_keystream(*key_schedule_, offs, body_size);
+    const uint8_t size_byte = decrypt_byte(input[body_size - 1], kstream[body_size - 1]);
+    const std::size_t data_size = decrypted_size_(encrypted_size, size_byte);
+    add_metric(metric_counter::decrypt_calls);
+    add_metric(metric_counter::decrypted_bytes, data_size);
+    decrypt_seq_(input, output, data_size, kstream, policy);
+    return data_size;
+}
+
+// add/remove data size
+std::size_t symcrypt_base::decrypted_size_(std::size_t encrypted_size, uint8_t size_byte)
+{
+    const std::size_t body_size = encrypted_size - std::tuple_size_v<offsets>;
+    if (size_byte <= min_data_size) [[unlikely]]
+        return size_byte;
+    return body_size - 1;
+}
+
+symcrypt_base::offsets symcrypt_base::random_offsets_(const uint8_t* random_bytes, std::size_t data_size)
+{
+    offsets offs;
+    std::ranges::copy_n(random_bytes + random_bytes_size_(data_size) - offs.size(), offs.size(), offs.begin());
+    return offs;
+}
+
+// encrypt/decrypt offsets
+void symcrypt_base::encrypt_and_stores_offsets_(uint8_t* output, const offsets& offs) const
+{
+    const key_schedule::key_hash_bytes_array& key_hash_bytes = key_schedule_->key_hash_bytes();
+    for (std::size_t i = 0; i < offs.size(); ++i)
+        output[i] = offs[i] + key_hash_bytes[i];
+}
+
+void symcrypt_base::decrypt_and_retrieves_offsets_(const key_schedule& schedule, const uint8_t* input, offsets& offs)
+{
+    const key_schedule::key_hash_bytes_array& key_hash_bytes = schedule.key_hash_bytes();
+    for (std::size_t i = 0; i < offs.size(); ++i)
+        offs[i] = input[i] - key_hash_bytes[i];
+}
+
+// encrypt/decrypt bytes
+void symcrypt_base::encrypt_seq_(const uint8_t* input, uint8_t* output, std::size_t size, const keystream& kstream,
+                                 const execution_policy& policy, std::size_t first_index) const
+{
+    transform_seq(input, output, size, first_index, policy, parallel_executor(),
+                  [&kstream](const uint8_t* in, uint8_t* out, std::size_t count, std::size_t index)
+                  { kstream.encrypt(in, out, count, index); });
+}
+
+void symcrypt_base::decrypt_seq_(const uint8_t* input, uint8_t* output, std::size_t size, const keystream& kstream,
+                                 const execution_policy& policy, std::size_t first_index) const
+{
+    transform_seq(input, output, size, first_index, policy, parallel_executor(),
+                  [&kstream](const uint8_t* in, uint8_t* out, std::size_t count, std::size_t index)
+                  { kstream.decrypt(in, out, count, index); });
+}
+
+} // namespace cryp
+} // namespace arba
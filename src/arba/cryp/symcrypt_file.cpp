@@ -0,0 +1,985 @@
+#include <arba/cryp/metrics.hpp>
+#include <arba/cryp/symcrypt_file.hpp>
+#include <arba/cryp/symcrypt_range.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define ARBA_CRYP_IO_URING_IS_AVAILABLE 1
+#else
+#define ARBA_CRYP_IO_URING_IS_AVAILABLE 0
+#endif
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+#if defined(_WIN32)
+[[noreturn]] void throw_file_error(const char* what, const std::filesystem::path& path)
+{
+    throw std::filesystem::filesystem_error(what, path, std::make_error_code(std::errc::io_error));
+}
+
+std::vector<std::byte> read_file(const std::filesystem::path& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        throw_file_error("Cannot open the input file", path);
+    std::vector<std::byte> bytes(std::filesystem::file_size(path));
+    if (!stream.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+        throw_file_error("Cannot read the input file", path);
+    return bytes;
+}
+
+// Fallback without memory mapping: the input file is read in memory, and the output file is written at once.
+template <class OutputSizeFunction, class TransformFunction>
+std::size_t transform_file_content(const std::filesystem::path& input_path, const std::filesystem::path& output_path,
+                                  OutputSizeFunction output_size_of, TransformFunction transform,
+                                  bool& output_is_created)
+{
+    const std::vector<std::byte> input = read_file(input_path);
+    std::vector<std::byte> output(output_size_of(std::span<const std::byte>(input)));
+    transform(std::span<const std::byte>(input), std::span<std::byte>(output));
+    std::ofstream stream(output_path, std::ios::binary | std::ios::trunc);
+    output_is_created = stream.is_open();
+    if (!stream.write(reinterpret_cast<const char*>(output.data()), static_cast<std::streamsize>(output.size())))
+        throw_file_error("Cannot write the output file", output_path);
+    return output.size();
+}
+#else
+[[noreturn]] void throw_file_error(const char* what, const std::filesystem::path& path)
+{
+    throw std::filesystem::filesystem_error(what, path, std::error_code(errno, std::generic_category()));
+}
+
+class file_descriptor
+{
+public:
+    file_descriptor(const std::filesystem::path& path, int flags, mode_t mode = 0)
+        : descriptor_(::open(path.c_str(), flags | O_CLOEXEC, mode))
+    {
+        if (descriptor_ < 0)
+            throw_file_error("Cannot open the file", path);
+    }
+    // Takes ownership of an open descriptor.
+    explicit file_descriptor(int descriptor) : descriptor_(descriptor) {}
+    file_descriptor(const file_descriptor&) = delete;
+    file_descriptor& operator=(const file_descriptor&) = delete;
+    ~file_descriptor() { ::close(descriptor_); }
+
+    inline int get() const { return descriptor_; }
+
+private:
+    int descriptor_;
+};
+
+// Maps a whole file in memory. An empty file is not mapped.
+class file_mapping
+{
+public:
+    file_mapping(const file_descriptor& file, std::size_t size, bool writable, const std::filesystem::path& path)
+        : size_(size)
+    {
+        if (size_ == 0)
+            return;
+        const int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* address = ::mmap(nullptr, size_, protection, MAP_SHARED, file.get(), 0);
+        if (address == MAP_FAILED)
+            throw_file_error("Cannot map the file in memory", path);
+        address_ = static_cast<std::byte*>(address);
+        // The mapping is walked once, from the beginning to the end: the kernel can read ahead aggressively.
+        ::madvise(address_, size_, MADV_SEQUENTIAL);
+    }
+    file_mapping(const file_mapping&) = delete;
+    file_mapping& operator=(const file_mapping&) = delete;
+    ~file_mapping()
+    {
+        if (address_)
+            ::munmap(address_, size_);
+    }
+
+    inline std::span<std::byte> bytes() const { return std::span(address_, size_); }
+
+private:
+    std::byte* address_ = nullptr;
+    std::size_t size_;
+};
+
+std::size_t file_size(const file_descriptor& file, const std::filesystem::path& path)
+{
+    struct stat status;
+    if (::fstat(file.get(), &status) != 0)
+        throw_file_error("Cannot get the size of the file", path);
+    return static_cast<std::size_t>(status.st_size);
+}
+
+template <class OutputSizeFunction, class TransformFunction>
+std::size_t transform_file_content(const std::filesystem::path& input_path, const std::filesystem::path& output_path,
+                                  OutputSizeFunction output_size_of, TransformFunction transform,
+                                  bool& output_is_created)
+{
+    const file_descriptor input_file(input_path, O_RDONLY);
+    const file_mapping input_mapping(input_file, file_size(input_file, input_path), false, input_path);
+    const std::span<const std::byte> input = input_mapping.bytes();
+    const std::size_t output_size = output_size_of(input);
+
+    // The output file is resized before being mapped, so that the trailer is written in the mapping too.
+    const file_descriptor output_file(output_path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    output_is_created = true;
+    if (::ftruncate(output_file.get(), static_cast<off_t>(output_size)) != 0)
+        throw_file_error("Cannot resize the file", output_path);
+    const file_mapping output_mapping(output_file, output_size, true, output_path);
+    transform(input, output_mapping.bytes());
+    return output_size;
+}
+
+// Asynchronous reads and writes
+
+void read_all(const file_descriptor& file, std::span<std::byte> bytes, std::size_t offset,
+              const std::filesystem::path& path)
+{
+    while (!bytes.empty())
+    {
+        const ssize_t result = ::pread(file.get(), bytes.data(), bytes.size(), static_cast<off_t>(offset));
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+        {
+            if (result == 0)
+                errno = EIO;
+            throw_file_error("Cannot read the file", path);
+        }
+        bytes = bytes.subspan(static_cast<std::size_t>(result));
+        offset += static_cast<std::size_t>(result);
+    }
+}
+
+void write_all(const file_descriptor& file, std::span<const std::byte> bytes, std::size_t offset,
+               const std::filesystem::path& path)
+{
+    while (!bytes.empty())
+    {
+        const ssize_t result = ::pwrite(file.get(), bytes.data(), bytes.size(), static_cast<off_t>(offset));
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result < 0)
+            throw_file_error("Cannot write the file", path);
+        bytes = bytes.subspan(static_cast<std::size_t>(result));
+        offset += static_cast<std::size_t>(result);
+    }
+}
+
+struct io_request
+{
+    bool is_write;
+    int descriptor;
+    std::byte* data;
+    std::size_t size;
+    std::size_t offset;
+    // Index of the buffer holding data, returned with the completion.
+    std::size_t buffer_index;
+};
+
+struct io_completion
+{
+    std::size_t buffer_index;
+    // Number of bytes read or written, or -errno.
+    ssize_t result;
+};
+
+// Queue of in-flight reads and writes, with at most one request per buffer.
+class io_queue
+{
+public:
+    virtual ~io_queue() = default;
+    virtual void submit(const io_request& request) = 0;
+    // Waits for at least one completion, and appends the completions to completions.
+    virtual void wait(std::vector<io_completion>& completions) = 0;
+};
+
+// The requests are processed by threads calling pread()/pwrite().
+class thread_io_queue : public io_queue
+{
+public:
+    explicit thread_io_queue(std::size_t thread_count)
+    {
+        threads_.reserve(thread_count);
+        for (std::size_t i = 0; i < thread_count; ++i)
+            threads_.emplace_back([this] { run_(); });
+    }
+
+    ~thread_io_queue() override
+    {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        request_condition_.notify_all();
+        for (std::thread& thread : threads_)
+            thread.join();
+    }
+
+    void submit(const io_request& request) override
+    {
+        {
+            std::lock_guard lock(mutex_);
+            requests_.push_back(request);
+        }
+        request_condition_.notify_one();
+    }
+
+    void wait(std::vector<io_completion>& completions) override
+    {
+        std::unique_lock lock(mutex_);
+        completion_condition_.wait(lock, [this] { return !completions_.empty(); });
+        completions.insert(completions.end(), completions_.begin(), completions_.end());
+        completions_.clear();
+    }
+
+private:
+    void run_()
+    {
+        std::unique_lock lock(mutex_);
+        for (;;)
+        {
+            request_condition_.wait(lock, [this] { return stopping_ || !requests_.empty(); });
+            if (stopping_)
+                return;
+            const io_request request = requests_.front();
+            requests_.pop_front();
+            lock.unlock();
+            ssize_t result = 0;
+            do
+            {
+                const off_t offset = static_cast<off_t>(request.offset);
+                result = request.is_write ? ::pwrite(request.descriptor, request.data, request.size, offset)
+                                          : ::pread(request.descriptor, request.data, request.size, offset);
+            } while (result < 0 && errno == EINTR);
+            const io_completion completion{ request.buffer_index, result < 0 ? -errno : result };
+            lock.lock();
+            completions_.push_back(completion);
+            completion_condition_.notify_one();
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable request_condition_;
+    std::condition_variable completion_condition_;
+    std::deque<io_request> requests_;
+    std::vector<io_completion> completions_;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+#if ARBA_CRYP_IO_URING_IS_AVAILABLE
+// liburing is not required: the io_uring system calls are made directly.
+int io_uring_setup(unsigned entry_count, io_uring_params& params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entry_count, &params));
+}
+
+int io_uring_enter(int ring, unsigned submission_count, unsigned min_completion_count, unsigned flags)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring, submission_count, min_completion_count, flags,
+                                      nullptr, 0));
+}
+
+int io_uring_register(int ring, unsigned opcode, const void* args, unsigned arg_count)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, ring, opcode, args, arg_count));
+}
+
+[[noreturn]] void throw_io_uring_error(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Memory shared with the kernel by an io_uring.
+class ring_mapping
+{
+public:
+    ring_mapping(const file_descriptor& ring, std::size_t size, off_t offset) : size_(size)
+    {
+        address_ = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.get(), offset);
+        if (address_ == MAP_FAILED)
+            throw_io_uring_error("Cannot map the io_uring in memory");
+    }
+    ring_mapping(const ring_mapping&) = delete;
+    ring_mapping& operator=(const ring_mapping&) = delete;
+    ~ring_mapping() { ::munmap(address_, size_); }
+
+    template <class Type>
+    inline Type* at(std::size_t offset) const
+    {
+        return reinterpret_cast<Type*>(static_cast<std::byte*>(address_) + offset);
+    }
+
+private:
+    void* address_;
+    std::size_t size_;
+};
+
+// The requests are queued in the submission ring of an io_uring, and submitted when the completions are waited for.
+// The buffers are registered, so that the kernel does not map them for each request.
+// If the wait fails, the requests in flight are cancelled and their completions reaped before the error is thrown, as
+// the caller releases the buffers.
+class uring_io_queue : public io_queue
+{
+public:
+    // Throws std::system_error if the io_uring cannot be set up.
+    explicit uring_io_queue(std::span<const iovec> buffers)
+        : ring_(create_ring_(static_cast<unsigned>(buffers.size()), params_)),
+          submission_ring_(ring_, params_.sq_off.array + params_.sq_entries * sizeof(unsigned), IORING_OFF_SQ_RING),
+          completion_ring_(ring_, params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe), IORING_OFF_CQ_RING),
+          submission_entries_(ring_, params_.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES)
+    {
+        // Registering the buffers may fail if they exceed RLIMIT_MEMLOCK: they are then used unregistered.
+        buffers_are_registered_ = io_uring_register(ring_.get(), IORING_REGISTER_BUFFERS, buffers.data(),
+                                                    static_cast<unsigned>(buffers.size())) == 0;
+        in_flight_.resize(buffers.size(), false);
+    }
+
+    void submit(const io_request& request) override
+    {
+        io_uring_sqe& entry = next_submission_entry_();
+        if (buffers_are_registered_)
+        {
+            entry.opcode = request.is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+            entry.buf_index = static_cast<uint16_t>(request.buffer_index);
+        }
+        else
+            entry.opcode = request.is_write ? IORING_OP_WRITE : IORING_OP_READ;
+        entry.fd = request.descriptor;
+        entry.off = request.offset;
+        entry.addr = reinterpret_cast<uint64_t>(request.data);
+        // A larger request is completed partially, and submitted again for the rest.
+        entry.len = static_cast<uint32_t>(std::min<std::size_t>(request.size, max_request_size));
+        entry.user_data = request.buffer_index;
+        push_submission_entry_();
+        in_flight_[request.buffer_index] = true;
+        ++in_flight_count_;
+    }
+
+    void wait(std::vector<io_completion>& completions) override
+    {
+        int submission_count = 0;
+        while ((submission_count = io_uring_enter(ring_.get(), pending_submission_count_, 1,
+                                                  IORING_ENTER_GETEVENTS)) < 0)
+        {
+            if (errno != EINTR)
+            {
+                // The buffers are released by the caller once the exception is thrown: the kernel must not use them
+                // anymore.
+                const int error = errno;
+                cancel_requests_();
+                errno = error;
+                throw_io_uring_error("Cannot submit the io_uring requests");
+            }
+        }
+        pending_submission_count_ -= static_cast<unsigned>(submission_count);
+        reap_completions_(&completions);
+    }
+
+private:
+    inline constexpr static std::size_t max_request_size = std::size_t(1) << 30;
+    // User data of the cancellation requests, which is not a buffer index.
+    inline constexpr static uint64_t cancel_user_data = std::numeric_limits<uint64_t>::max();
+
+    // Entry at the tail of the submission ring, appended by push_submission_entry_() once filled.
+    io_uring_sqe& next_submission_entry_()
+    {
+        const unsigned index = *submission_ring_.at<unsigned>(params_.sq_off.tail) &
+                               *submission_ring_.at<unsigned>(params_.sq_off.ring_mask);
+        submission_ring_.at<unsigned>(params_.sq_off.array)[index] = index;
+        io_uring_sqe& entry = submission_entries_.at<io_uring_sqe>(0)[index];
+        entry = io_uring_sqe{};
+        return entry;
+    }
+
+    // The entry is submitted by the next io_uring_enter().
+    void push_submission_entry_()
+    {
+        unsigned* tail = submission_ring_.at<unsigned>(params_.sq_off.tail);
+        std::atomic_ref(*tail).store(*tail + 1, std::memory_order_release);
+        ++pending_submission_count_;
+    }
+
+    unsigned free_submission_entry_count_() const
+    {
+        const unsigned head = std::atomic_ref(*submission_ring_.at<unsigned>(params_.sq_off.head))
+                                  .load(std::memory_order_acquire);
+        return params_.sq_entries - (*submission_ring_.at<unsigned>(params_.sq_off.tail) - head);
+    }
+
+    // Appends the completions of the requests to completions (if not null), and skips the other ones.
+    void reap_completions_(std::vector<io_completion>* completions)
+    {
+        unsigned* head = completion_ring_.at<unsigned>(params_.cq_off.head);
+        const unsigned tail = std::atomic_ref(*completion_ring_.at<unsigned>(params_.cq_off.tail))
+                                  .load(std::memory_order_acquire);
+        const unsigned mask = *completion_ring_.at<unsigned>(params_.cq_off.ring_mask);
+        const io_uring_cqe* entries = completion_ring_.at<io_uring_cqe>(params_.cq_off.cqes);
+        for (unsigned index = *head; index != tail; ++index)
+        {
+            const io_uring_cqe& entry = entries[index & mask];
+            if (entry.user_data == cancel_user_data)
+                continue;
+            const std::size_t buffer_index = static_cast<std::size_t>(entry.user_data);
+            in_flight_[buffer_index] = false;
+            --in_flight_count_;
+            if (completions)
+                completions->push_back(io_completion{ buffer_index, entry.res });
+        }
+        std::atomic_ref(*head).store(tail, std::memory_order_release);
+    }
+
+    // Cancels the requests in flight (IORING_OP_ASYNC_CANCEL), and reaps all their completions.
+    void cancel_requests_()
+    {
+        const auto enter = [this](unsigned min_completion_count)
+        {
+            const int submission_count =
+                io_uring_enter(ring_.get(), pending_submission_count_, min_completion_count, IORING_ENTER_GETEVENTS);
+            if (submission_count > 0)
+                pending_submission_count_ -= static_cast<unsigned>(submission_count);
+            else if (submission_count < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            {
+                // The requests are not submitted anymore, and the completions of the submitted ones are polled.
+                drop_pending_submissions_();
+                std::this_thread::yield();
+            }
+            reap_completions_(nullptr);
+        };
+        for (std::size_t buffer_index = 0; buffer_index < in_flight_.size(); ++buffer_index)
+        {
+            if (!in_flight_[buffer_index])
+                continue;
+            while (free_submission_entry_count_() == 0)
+                enter(0);
+            io_uring_sqe& entry = next_submission_entry_();
+            entry.opcode = IORING_OP_ASYNC_CANCEL;
+            entry.fd = -1;
+            entry.addr = buffer_index;
+            entry.user_data = cancel_user_data;
+            push_submission_entry_();
+        }
+        while (in_flight_count_ > 0)
+            enter(1);
+    }
+
+    // Removes the entries not consumed by the kernel from the submission ring: their buffers are not used.
+    void drop_pending_submissions_()
+    {
+        const unsigned head = std::atomic_ref(*submission_ring_.at<unsigned>(params_.sq_off.head))
+                                  .load(std::memory_order_acquire);
+        unsigned* tail = submission_ring_.at<unsigned>(params_.sq_off.tail);
+        const unsigned mask = *submission_ring_.at<unsigned>(params_.sq_off.ring_mask);
+        for (unsigned index = head; index != *tail; ++index)
+        {
+            const unsigned entry_index = submission_ring_.at<unsigned>(params_.sq_off.array)[index & mask];
+            const io_uring_sqe& entry = submission_entries_.at<io_uring_sqe>(0)[entry_index];
+            if (entry.user_data == cancel_user_data)
+                continue;
+            in_flight_[static_cast<std::size_t>(entry.user_data)] = false;
+            --in_flight_count_;
+        }
+        std::atomic_ref(*tail).store(head, std::memory_order_release);
+        pending_submission_count_ = 0;
+    }
+
+    static int create_ring_(unsigned entry_count, io_uring_params& params)
+    {
+        params = io_uring_params{};
+        const int ring = io_uring_setup(entry_count, params);
+        if (ring < 0)
+            throw_io_uring_error("Cannot set up the io_uring");
+        return ring;
+    }
+
+private:
+    io_uring_params params_;
+    file_descriptor ring_;
+    ring_mapping submission_ring_;
+    ring_mapping completion_ring_;
+    ring_mapping submission_entries_;
+    bool buffers_are_registered_ = false;
+    unsigned pending_submission_count_ = 0;
+    // Buffers whose request is submitted, or queued to be, and not completed.
+    std::vector<bool> in_flight_;
+    std::size_t in_flight_count_ = 0;
+};
+
+bool io_uring_is_available()
+{
+    // IORING_OP_READ and IORING_OP_WRITE come with IORING_FEAT_RW_CUR_POS (Linux 5.6).
+    static const bool is_available = []
+    {
+        io_uring_params params{};
+        const int ring = io_uring_setup(1, params);
+        if (ring < 0)
+            return false;
+        ::close(ring);
+        return (params.features & IORING_FEAT_RW_CUR_POS) != 0;
+    }();
+    return is_available;
+}
+#endif
+
+// Maximum number of buffers, and so of requests in flight.
+constexpr std::size_t max_buffer_count = 1024;
+
+std::unique_ptr<io_queue> make_io_queue(file_io_backend backend, std::span<const iovec> buffers)
+{
+#if ARBA_CRYP_IO_URING_IS_AVAILABLE
+    if (backend == file_io_backend::io_uring)
+        return std::make_unique<uring_io_queue>(buffers);
+    if (backend == file_io_backend::automatic && io_uring_is_available())
+    {
+        try
+        {
+            return std::make_unique<uring_io_queue>(buffers);
+        }
+        catch (const std::system_error&)
+        {
+            // The thread queue is used instead.
+        }
+    }
+#endif
+    // A few threads are enough to keep several requests queued on the device.
+    constexpr std::size_t max_io_thread_count = 4;
+    return std::make_unique<thread_io_queue>(std::min(buffers.size(), max_io_thread_count));
+}
+
+// Transforms the data_size first bytes of the input file into the output file, at the same offsets, chunk by chunk.
+// Each buffer holds a chunk, read then transformed then written, before being reused for the next chunk. The chunks
+// read so far are transformed at once, while the requests of the other buffers are processed.
+// transform(offset, bytes) transforms in place the chunk starting at offset.
+template <class TransformFunction>
+void transform_file_chunks(const file_descriptor& input_file, const std::filesystem::path& input_path,
+                           const file_descriptor& output_file, const std::filesystem::path& output_path,
+                           std::size_t data_size, const async_file_options& options, const execution_policy& policy,
+                           executor& exec, TransformFunction transform)
+{
+    const std::size_t chunk_size = options.chunk_size;
+    const std::size_t chunk_count = (data_size + chunk_size - 1) / chunk_size;
+    const std::size_t buffer_count = std::min(
+        { options.buffer_count ? options.buffer_count : 2 * exec.concurrency() + 2, max_buffer_count, chunk_count });
+    if (buffer_count == 0)
+        return;
+
+    std::vector<std::byte> buffer_bytes(buffer_count * chunk_size);
+    std::vector<iovec> buffers(buffer_count);
+    for (std::size_t i = 0; i < buffer_count; ++i)
+        buffers[i] = iovec{ buffer_bytes.data() + i * chunk_size, chunk_size };
+    const std::unique_ptr<io_queue> queue = make_io_queue(options.backend, buffers);
+
+    struct chunk
+    {
+        std::size_t offset;
+        std::size_t size;
+        // Number of bytes already read or written.
+        std::size_t done_size;
+        // False while the chunk is read, true while it is written.
+        bool writing;
+    };
+    std::vector<chunk> chunks(buffer_count);
+    std::size_t next_chunk_index = 0;
+    std::size_t in_flight_count = 0;
+    const auto submit = [&](std::size_t buffer_index)
+    {
+        const chunk& current_chunk = chunks[buffer_index];
+        queue->submit(io_request{ current_chunk.writing, current_chunk.writing ? output_file.get() : input_file.get(),
+                                  buffer_bytes.data() + buffer_index * chunk_size + current_chunk.done_size,
+                                  current_chunk.size - current_chunk.done_size,
+                                  current_chunk.offset + current_chunk.done_size, buffer_index });
+        ++in_flight_count;
+    };
+    const auto read_next_chunk = [&](std::size_t buffer_index)
+    {
+        const std::size_t offset = next_chunk_index++ * chunk_size;
+        chunks[buffer_index] = chunk{ offset, std::min(chunk_size, data_size - offset), 0, false };
+        submit(buffer_index);
+    };
+    for (std::size_t buffer_index = 0; buffer_index < buffer_count; ++buffer_index)
+        read_next_chunk(buffer_index);
+
+    // After an error, no request is submitted anymore, but the requests in flight are waited for, as they use the
+    // buffers.
+    std::exception_ptr first_exception;
+    std::vector<io_completion> completions;
+    std::vector<std::size_t> read_buffer_indexes;
+    while (in_flight_count > 0)
+    {
+        completions.clear();
+        queue->wait(completions);
+        for (const io_completion& completion : completions)
+        {
+            --in_flight_count;
+            chunk& current_chunk = chunks[completion.buffer_index];
+            if (first_exception)
+                continue;
+            if (completion.result <= 0) [[unlikely]]
+            {
+                // A read of 0 bytes means that the input file was truncated meanwhile.
+                const int error = completion.result < 0 ? static_cast<int>(-completion.result) : EIO;
+                first_exception = std::make_exception_ptr(std::filesystem::filesystem_error(
+                    current_chunk.writing ? "Cannot write the file" : "Cannot read the file",
+                    current_chunk.writing ? output_path : input_path, std::error_code(error, std::generic_category())));
+                continue;
+            }
+            current_chunk.done_size += static_cast<std::size_t>(completion.result);
+            if (current_chunk.done_size < current_chunk.size)
+                submit(completion.buffer_index);
+            else if (!current_chunk.writing)
+                read_buffer_indexes.push_back(completion.buffer_index);
+            else if (next_chunk_index < chunk_count)
+                read_next_chunk(completion.buffer_index);
+        }
+        if (first_exception || read_buffer_indexes.empty())
+            continue;
+
+        // All the chunks read so far are transformed at once.
+        std::size_t batch_size = 0;
+        for (std::size_t buffer_index : read_buffer_indexes)
+            batch_size += chunks[buffer_index].size;
+        const std::size_t read_count = read_buffer_indexes.size();
+        const std::size_t task_count = std::min(policy.thread_count(batch_size), read_count);
+        const auto transform_chunks = [&](std::size_t first, std::size_t last)
+        {
+            for (std::size_t buffer_index : std::span(read_buffer_indexes).subspan(first, last - first))
+                transform(chunks[buffer_index].offset,
+                          std::span(buffer_bytes.data() + buffer_index * chunk_size, chunks[buffer_index].size));
+        };
+        try
+        {
+            scoped_phase_timer timer(metric_phase::transform);
+            if (task_count <= 1)
+            {
+                add_metric(metric_counter::sequential_dispatches);
+                transform_chunks(0, read_count);
+            }
+            else
+            {
+                add_metric(metric_counter::parallel_dispatches);
+                add_metric(metric_counter::parallel_tasks, task_count);
+                exec.bulk_execute(task_count,
+                                  [&](std::size_t task_index)
+                                  {
+                                      transform_chunks(read_count * task_index / task_count,
+                                                       read_count * (task_index + 1) / task_count);
+                                  });
+            }
+        }
+        catch (...)
+        {
+            first_exception = std::current_exception();
+            continue;
+        }
+        for (std::size_t buffer_index : read_buffer_indexes)
+        {
+            chunks[buffer_index].done_size = 0;
+            chunks[buffer_index].writing = true;
+            submit(buffer_index);
+        }
+        read_buffer_indexes.clear();
+    }
+    if (first_exception)
+        std::rethrow_exception(first_exception);
+}
+#endif
+
+// process_content(output_is_created) writes the output file, and returns its size.
+template <class ContentFunction>
+std::size_t process_file(const std::filesystem::path& input_path, const std::filesystem::path& output_path,
+                         ContentFunction process_content)
+{
+    std::error_code error;
+    if (std::filesystem::equivalent(input_path, output_path, error)) [[unlikely]]
+        throw std::invalid_argument("symcrypt: input and output files must be different.");
+
+    bool output_is_created = false;
+    try
+    {
+        return process_content(output_is_created);
+    }
+    catch (...)
+    {
+        // A partially written output file is useless.
+        if (output_is_created)
+            std::filesystem::remove(output_path, error);
+        throw;
+    }
+}
+
+template <class OutputSizeFunction, class TransformFunction>
+std::size_t transform_file(const std::filesystem::path& input_path, const std::filesystem::path& output_path,
+                           OutputSizeFunction output_size_of, TransformFunction transform)
+{
+    return process_file(input_path, output_path,
+                        [&](bool& output_is_created) {
+                            return transform_file_content(input_path, output_path, output_size_of, transform,
+                                                          output_is_created);
+                        });
+}
+
+void check_async_file_options(const async_file_options& options)
+{
+    if (options.chunk_size == 0) [[unlikely]]
+        throw std::invalid_argument("symcrypt: the chunk size must not be 0.");
+    if (!file_io_backend_is_available(options.backend)) [[unlikely]]
+        throw std::invalid_argument("symcrypt: the file I/O backend is not available.");
+}
+} // namespace
+
+std::size_t encrypt_file(symcrypt_base& symcrypt, const std::filesystem::path& input_path,
+                         const std::filesystem::path& output_path, const execution_policy& policy)
+{
+    return transform_file(
+        input_path, output_path, [](std::span<const std::byte> input)
+        { return symcrypt_base::encrypted_size(input.size()); },
+        [&](std::span<const std::byte> input, std::span<std::byte> output)
+        { symcrypt.encrypt(input, output, policy); });
+}
+
+std::size_t decrypt_file(symcrypt_base& symcrypt, const std::filesystem::path& input_path,
+                         const std::filesystem::path& output_path, const execution_policy& policy)
+{
+    return transform_file(
+        input_path, output_path, [&](std::span<const std::byte> input) { return symcrypt.decrypted_size(input); },
+        [&](std::span<const std::byte> input, std::span<std::byte> output)
+        { symcrypt.decrypt(input, output, policy); });
+}
+
+bool file_io_backend_is_available(file_io_backend backend)
+{
+#if ARBA_CRYP_IO_URING_IS_AVAILABLE
+    return backend != file_io_backend::io_uring || io_uring_is_available();
+#else
+    return backend != file_io_backend::io_uring;
+#endif
+}
+
+std::size_t encrypt_file_async(symcrypt_base& symcrypt, const std::filesystem::path& input_path,
+                               const std::filesystem::path& output_path, const async_file_options& options,
+                               const execution_policy& policy)
+{
+    check_async_file_options(options);
+#if defined(_WIN32)
+    return encrypt_file(symcrypt, input_path, output_path, policy);
+#else
+    return process_file(
+        input_path, output_path,
+        [&](bool& output_is_created)
+        {
+            const file_descriptor input_file(input_path, O_RDONLY);
+            const std::size_t data_size = file_size(input_file, input_path);
+            const symcrypt_range_encryptor encryptor(symcrypt, data_size);
+            const file_descriptor output_file(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+            output_is_created = true;
+            transform_file_chunks(input_file, input_path, output_file, output_path, data_size, options, policy,
+                                  symcrypt.parallel_executor(), [&](std::size_t offset, std::span<std::byte> bytes)
+                                  { encryptor.encrypt_range(offset, bytes); });
+            write_all(output_file, encryptor.trailer(), data_size, output_path);
+            return encryptor.encrypted_size();
+        });
+#endif
+}
+
+std::size_t decrypt_file_async(const symcrypt_base& symcrypt, const std::filesystem::path& input_path,
+                               const std::filesystem::path& output_path, const async_file_options& options,
+                               const execution_policy& policy)
+{
+    check_async_file_options(options);
+#if defined(_WIN32)
+    return decrypt_file(symcrypt, input_path, output_path, policy);
+#else
+    return process_file(
+        input_path, output_path,
+        [&](bool& output_is_created)
+        {
+            const file_descriptor input_file(input_path, O_RDONLY);
+            const std::size_t encrypted_size = file_size(input_file, input_path);
+            if (encrypted_size < symcrypt_base::min_encrypted_size) [[unlikely]]
+                throw std::invalid_argument("symcrypt: encrypted data are too small.");
+            std::array<std::byte, symcrypt_base::trailer_size> trailer;
+            read_all(input_file, trailer, encrypted_size - trailer.size(), input_path);
+            const symcrypt_range_decryptor decryptor(symcrypt, trailer, encrypted_size);
+            const file_descriptor output_file(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+            output_is_created = true;
+            transform_file_chunks(input_file, input_path, output_file, output_path, decryptor.data_size(), options,
+                                  policy, symcrypt.parallel_executor(),
+                                  [&](std::size_t offset, std::span<std::byte> bytes)
+                                  { decryptor.decrypt_range(offset, bytes); });
+            return decryptor.data_size();
+        });
+#endif
+}
+
+// bulk_file_job
+
+bulk_file_job::bulk_file_job(symcrypt_base& symcrypt) : symcrypt_(&symcrypt)
+{
+}
+
+void bulk_file_job::add_file(const std::filesystem::path& input_path, const std::filesystem::path& output_path)
+{
+    files_.push_back(file_paths{ input_path, output_path });
+}
+
+void bulk_file_job::add_directory(const std::filesystem::path& input_directory,
+                                  const std::filesystem::path& output_directory)
+{
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(input_directory))
+    {
+        if (entry.is_regular_file())
+            add_file(entry.path(), output_directory / entry.path().lexically_relative(input_directory));
+    }
+}
+
+std::size_t bulk_file_job::encrypt(const execution_policy& policy)
+{
+    // The random bytes generator of the symcrypt is not meant to be called by several threads at once.
+    std::mutex random_bytes_mutex;
+    return run_(policy,
+                [&](const file_paths& paths)
+                {
+                    return transform_file(
+                        paths.input_path, paths.output_path, [](std::span<const std::byte> input)
+                        { return symcrypt_base::encrypted_size(input.size()); },
+                        [&](std::span<const std::byte> input, std::span<std::byte> output)
+                        {
+                            symcrypt_base::random_bytes_array random_bytes;
+                            {
+                                std::lock_guard lock(random_bytes_mutex);
+                                random_bytes = symcrypt_->draw_random_bytes(input.size());
+                            }
+                            symcrypt_->encrypt(input, output, random_bytes, policy);
+                        });
+                });
+}
+
+std::size_t bulk_file_job::decrypt(const execution_policy& policy)
+{
+    return run_(policy,
+                [&](const file_paths& paths)
+                {
+                    return transform_file(
+                        paths.input_path, paths.output_path,
+                        [&](std::span<const std::byte> input) { return symcrypt_->decrypted_size(input); },
+                        [&](std::span<const std::byte> input, std::span<std::byte> output)
+                        { symcrypt_->decrypt(input, output, policy); });
+                });
+}
+
+template <class FileFunction>
+std::size_t bulk_file_job::run_(const execution_policy& policy, FileFunction process_file)
+{
+    // The largest files are processed first, so that the last tasks are short.
+    struct sized_file
+    {
+        const file_paths* paths;
+        std::size_t size;
+    };
+    std::vector<sized_file> files;
+    files.reserve(files_.size());
+    progress current_progress{ files_.size(), 0, 0, 0 };
+    for (const file_paths& paths : files_)
+    {
+        std::error_code error;
+        const std::uintmax_t size = std::filesystem::file_size(paths.input_path, error);
+        files.push_back(sized_file{ &paths, error ? 0 : static_cast<std::size_t>(size) });
+        current_progress.byte_count += files.back().size;
+    }
+    std::ranges::stable_sort(files, std::ranges::greater{}, &sized_file::size);
+
+    std::atomic_size_t next_file_index = 0;
+    std::atomic_size_t output_size = 0;
+    std::mutex progress_mutex;
+    std::exception_ptr first_exception;
+    const auto run_task = [&](std::size_t)
+    {
+        for (std::size_t file_index = next_file_index++; file_index < files.size(); file_index = next_file_index++)
+        {
+            const sized_file& file = files[file_index];
+            std::exception_ptr exception;
+            try
+            {
+                if (const std::filesystem::path parent_path = file.paths->output_path.parent_path();
+                    !parent_path.empty())
+                    std::filesystem::create_directories(parent_path);
+                output_size += process_file(*file.paths);
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+
+            std::lock_guard lock(progress_mutex);
+            if (exception && !first_exception)
+                first_exception = exception;
+            ++current_progress.done_file_count;
+            current_progress.done_byte_count += file.size;
+            if (progress_function_)
+                progress_function_(current_progress);
+        }
+    };
+
+    // The files are independent: they are spread over the threads of the executor, however small they are. The
+    // parallel threshold of the policy only applies to the transform of each file.
+    executor& exec = symcrypt_->parallel_executor();
+    std::size_t task_count = 1;
+    if (policy.execution_mode() != execution_policy::mode::sequential)
+    {
+        task_count = std::min(exec.concurrency() + 1, files.size());
+        if (policy.max_thread_count() != 0)
+            task_count = std::min(task_count, policy.max_thread_count());
+    }
+    if (task_count <= 1)
+    {
+        add_metric(metric_counter::sequential_dispatches);
+        run_task(0);
+    }
+    else
+    {
+        add_metric(metric_counter::parallel_dispatches);
+        add_metric(metric_counter::parallel_tasks, task_count);
+        exec.bulk_execute(task_count, run_task);
+    }
+    if (first_exception)
+        std::rethrow_exception(first_exception);
+    return output_size;
+}
+
+} // namespace cryp
+} // namespace arba
@@ -0,0 +1,370 @@
+#include <arba/cryp/metrics.hpp>
+#include <arba/cryp/symcrypt_pipeline.hpp>
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+// Chunks are numbered in reading order. The chunk number i is stored in the buffer i % buffer_count, and it goes
+// through the stages in order: read, transformed, written.
+class chunk_pipeline
+{
+public:
+    // Transforms in place the chunk of bytes starting at stream_index in the stream.
+    using transform_function = std::function<void(std::size_t stream_index, std::span<std::byte> chunk)>;
+
+    chunk_pipeline(const pipeline_options& options, executor& exec)
+        : chunk_size_(options.chunk_size), buffer_count_(options.buffer_count), executor_(exec)
+    {
+        if (chunk_size_ == 0) [[unlikely]]
+            throw std::invalid_argument("symcrypt_pipeline: the chunk size must not be 0.");
+        if (buffer_count_ == 0)
+            buffer_count_ = 2 * exec.concurrency() + 2;
+        buffers_.resize(chunk_size_ * buffer_count_);
+        chunks_.resize(buffer_count_);
+    }
+
+    // Runs the stages, and returns once all the chunks are written.
+    void run(const chunk_source& source, const transform_function& transform, const chunk_sink& sink,
+             const execution_policy& policy)
+    {
+        std::thread reading_thread([&] { run_stage_([&] { read_chunks_(source); }); });
+        std::thread transforming_thread([&] { run_stage_([&] { transform_chunks_(transform, policy); }); });
+        run_stage_([&] { write_chunks_(sink); });
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_all();
+        reading_thread.join();
+        transforming_thread.join();
+        if (exception_)
+            std::rethrow_exception(exception_);
+    }
+
+private:
+    struct chunk
+    {
+        std::size_t stream_index;
+        std::size_t size;
+    };
+
+    inline std::span<std::byte> chunk_bytes_(std::size_t chunk_number)
+    {
+        const std::size_t buffer_index = chunk_number % buffer_count_;
+        return std::span(buffers_).subspan(buffer_index * chunk_size_, chunks_[buffer_index].size);
+    }
+
+    template <class StageFunction>
+    void run_stage_(StageFunction stage)
+    {
+        try
+        {
+            stage();
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard lock(mutex_);
+                if (!exception_)
+                    exception_ = std::current_exception();
+                stopping_ = true;
+            }
+            condition_.notify_all();
+        }
+    }
+
+    void read_chunks_(const chunk_source& source)
+    {
+        std::size_t stream_index = 0;
+        for (std::size_t chunk_number = 0;; ++chunk_number)
+        {
+            // Back-pressure: wait for the buffer of the chunk to be written.
+            {
+                std::unique_lock lock(mutex_);
+                condition_.wait(lock, [&] { return stopping_ || chunk_number - written_count_ < buffer_count_; });
+                if (stopping_)
+                    return;
+            }
+
+            const std::size_t buffer_index = chunk_number % buffer_count_;
+            const std::size_t size = source(std::span(buffers_).subspan(buffer_index * chunk_size_, chunk_size_));
+            {
+                std::lock_guard lock(mutex_);
+                if (size == 0)
+                    input_is_ended_ = true;
+                else
+                {
+                    chunks_[buffer_index] = chunk{ stream_index, size };
+                    read_count_ = chunk_number + 1;
+                }
+            }
+            condition_.notify_all();
+            if (size == 0)
+                return;
+            stream_index += size;
+        }
+    }
+
+    void transform_chunks_(const transform_function& transform, const execution_policy& policy)
+    {
+        for (;;)
+        {
+            std::size_t first_chunk = 0;
+            std::size_t last_chunk = 0;
+            {
+                std::unique_lock lock(mutex_);
+                condition_.wait(lock,
+                                [this] { return stopping_ || input_is_ended_ || transformed_count_ < read_count_; });
+                if (stopping_)
+                    return;
+                if (transformed_count_ == read_count_)
+                {
+                    transform_is_ended_ = true;
+                    break;
+                }
+                first_chunk = transformed_count_;
+                last_chunk = read_count_;
+            }
+
+            // All the chunks read so far are transformed at once.
+            std::size_t batch_size = 0;
+            for (std::size_t chunk_number = first_chunk; chunk_number < last_chunk; ++chunk_number)
+                batch_size += chunk_bytes_(chunk_number).size();
+            const std::size_t chunk_count = last_chunk - first_chunk;
+            const std::size_t task_count = std::min(policy.thread_count(batch_size), chunk_count);
+            scoped_phase_timer timer(metric_phase::transform);
+            if (task_count <= 1)
+            {
+                add_metric(metric_counter::sequential_dispatches);
+                for (std::size_t chunk_number = first_chunk; chunk_number < last_chunk; ++chunk_number)
+                    transform_chunk_(transform, chunk_number);
+            }
+            else
+            {
+                add_metric(metric_counter::parallel_dispatches);
+                add_metric(metric_counter::parallel_tasks, task_count);
+                // Each task transforms a contiguous range of chunks, so that no more than task_count threads are used.
+                executor_.bulk_execute(
+                    task_count,
+                    [&](std::size_t task_index)
+                    {
+                        const std::size_t first = first_chunk + chunk_count * task_index / task_count;
+                        const std::size_t last = first_chunk + chunk_count * (task_index + 1) / task_count;
+                        for (std::size_t chunk_number = first; chunk_number < last; ++chunk_number)
+                            transform_chunk_(transform, chunk_number);
+                    });
+            }
+
+            {
+                std::lock_guard lock(mutex_);
+                transformed_count_ = last_chunk;
+            }
+            condition_.notify_all();
+        }
+        condition_.notify_all();
+    }
+
+    void transform_chunk_(const transform_function& transform, std::size_t chunk_number)
+    {
+        transform(chunks_[chunk_number % buffer_count_].stream_index, chunk_bytes_(chunk_number));
+    }
+
+    void write_chunks_(const chunk_sink& sink)
+    {
+        for (;;)
+        {
+            std::size_t last_chunk = 0;
+            {
+                std::unique_lock lock(mutex_);
+                condition_.wait(lock,
+                                [this]
+                                { return stopping_ || transform_is_ended_ || written_count_ < transformed_count_; });
+                if (stopping_ || written_count_ == transformed_count_)
+                    return;
+                last_chunk = transformed_count_;
+            }
+
+            for (std::size_t chunk_number = written_count_; chunk_number < last_chunk; ++chunk_number)
+            {
+                sink(chunk_bytes_(chunk_number));
+                // The buffer is given back to the reading stage as soon as possible.
+                {
+                    std::lock_guard lock(mutex_);
+                    written_count_ = chunk_number + 1;
+                }
+                condition_.notify_all();
+            }
+        }
+    }
+
+private:
+    std::size_t chunk_size_;
+    std::size_t buffer_count_;
+    executor& executor_;
+    std::vector<std::byte> buffers_;
+    std::vector<chunk> chunks_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::size_t read_count_ = 0;
+    std::size_t transformed_count_ = 0;
+    std::size_t written_count_ = 0;
+    bool input_is_ended_ = false;
+    bool transform_is_ended_ = false;
+    bool stopping_ = false;
+    std::exception_ptr exception_;
+};
+
+// Writes the decrypted body of a stream, except its last max_trailer_size bytes which may be padding.
+class held_back_sink
+{
+public:
+    explicit held_back_sink(const chunk_sink& sink) : sink_(sink) {}
+
+    void write(std::span<const std::byte> bytes)
+    {
+        const std::size_t available_size = held_size_ + bytes.size();
+        const std::size_t output_size = available_size > held_bytes_.size() ? available_size - held_bytes_.size() : 0;
+        const std::size_t held_output_size = std::min(output_size, held_size_);
+        if (held_output_size > 0)
+            sink_(std::span(held_bytes_).first(held_output_size));
+        const std::size_t bytes_output_size = output_size - held_output_size;
+        if (bytes_output_size > 0)
+            sink_(bytes.first(bytes_output_size));
+        written_size_ += output_size;
+
+        std::copy(held_bytes_.begin() + held_output_size, held_bytes_.begin() + held_size_, held_bytes_.begin());
+        held_size_ -= held_output_size;
+        std::ranges::copy(bytes.subspan(bytes_output_size), held_bytes_.begin() + held_size_);
+        held_size_ = available_size - output_size;
+    }
+
+    // Writes the held back data, and returns the data size.
+    std::size_t finish()
+    {
+        const uint8_t size_byte = held_size_ > 0 ? static_cast<uint8_t>(held_bytes_[held_size_ - 1]) : 0;
+        const std::size_t data_size =
+            symcrypt_stream_format::decrypted_data_size(written_size_ + held_size_, size_byte);
+        if (data_size > written_size_)
+            sink_(std::span(held_bytes_).first(data_size - written_size_));
+        return data_size;
+    }
+
+private:
+    const chunk_sink& sink_;
+    std::array<std::byte, symcrypt_stream_format::max_trailer_size> held_bytes_;
+    std::size_t held_size_ = 0;
+    std::size_t written_size_ = 0;
+};
+} // namespace
+
+chunk_source make_memory_source(std::span<const std::byte> bytes)
+{
+    return [bytes](std::span<std::byte> buffer) mutable
+    {
+        const std::size_t size = std::min(buffer.size(), bytes.size());
+        std::ranges::copy(bytes.first(size), buffer.begin());
+        bytes = bytes.subspan(size);
+        return size;
+    };
+}
+
+chunk_source make_stream_source(std::istream& stream)
+{
+    return [&stream](std::span<std::byte> buffer)
+    {
+        stream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (stream.bad()) [[unlikely]]
+            throw std::runtime_error("symcrypt_pipeline: cannot read the input stream.");
+        return static_cast<std::size_t>(stream.gcount());
+    };
+}
+
+chunk_sink make_vector_sink(std::vector<std::byte>& bytes)
+{
+    return [&bytes](std::span<const std::byte> chunk) { bytes.insert(bytes.end(), chunk.begin(), chunk.end()); };
+}
+
+chunk_sink make_stream_sink(std::ostream& stream)
+{
+    return [&stream](std::span<const std::byte> chunk)
+    {
+        if (!stream.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size())))
+            [[unlikely]]
+            throw std::runtime_error("symcrypt_pipeline: cannot write the output stream.");
+    };
+}
+
+std::size_t encrypt_pipeline(symcrypt_base& symcrypt, const chunk_source& source, const chunk_sink& sink,
+                             const pipeline_options& options, const execution_policy& policy)
+{
+    chunk_pipeline pipeline(options, symcrypt.parallel_executor());
+    symcrypt_encoder encoder(symcrypt);
+    std::array<std::byte, symcrypt_encoder::max_finish_size()> header_or_trailer;
+    std::size_t output_size = encoder.write_header(header_or_trailer);
+    sink(std::span(header_or_trailer).first(output_size));
+
+    std::size_t data_size = 0;
+    pipeline.run(
+        source,
+        [&encoder](std::size_t data_index, std::span<std::byte> chunk)
+        { encoder.encrypt_at(data_index, chunk, chunk); },
+        [&](std::span<const std::byte> chunk)
+        {
+            sink(chunk);
+            data_size += chunk.size();
+        },
+        policy);
+
+    encoder.advance(data_size);
+    const std::size_t trailer_size = encoder.finish(header_or_trailer);
+    sink(std::span(header_or_trailer).first(trailer_size));
+    add_metric(metric_counter::encrypt_calls);
+    add_metric(metric_counter::encrypted_bytes, data_size);
+    return output_size + data_size + trailer_size;
+}
+
+std::size_t decrypt_pipeline(const symcrypt_base& symcrypt, const chunk_source& source, const chunk_sink& sink,
+                             const pipeline_options& options, const execution_policy& policy)
+{
+    chunk_pipeline pipeline(options, symcrypt.parallel_executor());
+    symcrypt_decoder decoder(symcrypt);
+    std::array<std::byte, symcrypt_decoder::header_size> header;
+    std::size_t header_size = 0;
+    while (!decoder.header_is_read())
+    {
+        const std::size_t read_size = source(std::span(header).subspan(header_size));
+        if (read_size == 0) [[unlikely]]
+            throw std::invalid_argument("symcrypt: the stream is truncated.");
+        header_size += decoder.read_header(std::span(header).subspan(header_size, read_size));
+    }
+
+    held_back_sink body_sink(sink);
+    pipeline.run(
+        source,
+        [&decoder](std::size_t body_index, std::span<std::byte> chunk)
+        { decoder.decrypt_at(body_index, chunk, chunk); },
+        [&body_sink](std::span<const std::byte> chunk) { body_sink.write(chunk); }, policy);
+
+    const std::size_t data_size = body_sink.finish();
+    add_metric(metric_counter::decrypt_calls);
+    add_metric(metric_counter::decrypted_bytes, data_size);
+    return data_size;
+}
+
+} // namespace cryp
+} // namespace arba
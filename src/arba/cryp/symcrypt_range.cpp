@@ -0,0 +1,111 @@
+#include <arba/cryp/symcrypt_range.hpp>
+
+#include <array>
+#include <stdexcept>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+std::size_t checked_encrypted_size(std::size_t encrypted_size)
+{
+    if (encrypted_size < symcrypt_base::min_encrypted_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: encrypted data are too small.");
+    return encrypted_size;
+}
+} // namespace
+
+// encryptor
+
+symcrypt_range_encryptor::symcrypt_range_encryptor(symcrypt_base& symcrypt, std::size_t data_size)
+    : symcrypt_range_encryptor(symcrypt, data_size, symcrypt.draw_random_bytes(data_size))
+{
+}
+
+symcrypt_range_encryptor::symcrypt_range_encryptor(const symcrypt_base& symcrypt, std::size_t data_size,
+                                                   const symcrypt_base::random_bytes_array& random_bytes)
+    : data_size_(data_size), trailer_size_(symcrypt_base::scattered_trailer_size(data_size)),
+      keystream_(symcrypt.encrypt_trailer(data_size, random_bytes, trailer_))
+{
+}
+
+void symcrypt_range_encryptor::encrypt_range(std::size_t offset, std::span<const std::byte> input,
+                                             std::span<std::byte> output) const
+{
+    if (offset > data_size_ || input.size() > data_size_ - offset) [[unlikely]]
+        throw std::out_of_range("symcrypt: the range ends after the data.");
+    if (output.size() < input.size()) [[unlikely]]
+        throw std::invalid_argument("symcrypt: output is too small.");
+    keystream_.encrypt(reinterpret_cast<const uint8_t*>(input.data()), reinterpret_cast<uint8_t*>(output.data()),
+                       input.size(), offset);
+}
+
+void symcrypt_range_encryptor::encrypt_range(std::size_t offset, std::span<std::byte> bytes) const
+{
+    encrypt_range(offset, bytes, bytes);
+}
+
+// decryptor
+
+symcrypt_range_decryptor::symcrypt_range_decryptor(const symcrypt_base& symcrypt, trailer_span trailer,
+                                                   std::size_t encrypted_size)
+    : symcrypt_range_decryptor(*symcrypt.shared_key_schedule(),
+                               symcrypt_base::retrieve_offsets(*symcrypt.shared_key_schedule(),
+                                                               trailer.last<keystream::offsets_size>()),
+                               trailer[0], checked_encrypted_size(encrypted_size))
+{
+}
+
+symcrypt_range_decryptor::symcrypt_range_decryptor(const key_schedule& schedule, keystream::offsets_span offsets,
+                                                   std::byte encrypted_size_byte, std::size_t encrypted_size)
+    : keystream_(schedule, offsets),
+      data_size_(symcrypt_base::decrypted_size(schedule, offsets, encrypted_size_byte, encrypted_size))
+{
+}
+
+void symcrypt_range_decryptor::decrypt_range(std::size_t offset, std::span<const std::byte> input,
+                                             std::span<std::byte> output) const
+{
+    if (offset > data_size_ || input.size() > data_size_ - offset) [[unlikely]]
+        throw std::out_of_range("symcrypt: the range ends after the data.");
+    if (output.size() < input.size()) [[unlikely]]
+        throw std::invalid_argument("symcrypt: output is too small.");
+    keystream_.decrypt(reinterpret_cast<const uint8_t*>(input.data()), reinterpret_cast<uint8_t*>(output.data()),
+                       input.size(), offset);
+}
+
+void symcrypt_range_decryptor::decrypt_range(std::size_t offset, std::span<std::byte> bytes) const
+{
+    decrypt_range(offset, bytes, bytes);
+}
+
+// reader
+
+symcrypt_range_reader::symcrypt_range_reader(const symcrypt_base& symcrypt, std::size_t encrypted_size,
+                                             read_at_function read_at)
+    : read_at_(std::move(read_at)), decryptor_(make_decryptor_(symcrypt, encrypted_size, read_at_))
+{
+}
+
+symcrypt_range_decryptor symcrypt_range_reader::make_decryptor_(const symcrypt_base& symcrypt,
+                                                                std::size_t encrypted_size,
+                                                                const read_at_function& read_at)
+{
+    std::array<std::byte, symcrypt_base::trailer_size> trailer;
+    read_at(checked_encrypted_size(encrypted_size) - trailer.size(), trailer);
+    return symcrypt_range_decryptor(symcrypt, trailer, encrypted_size);
+}
+
+void symcrypt_range_reader::read(std::size_t offset, std::span<std::byte> output) const
+{
+    if (offset > data_size() || output.size() > data_size() - offset) [[unlikely]]
+        throw std::out_of_range("symcrypt: the range ends after the data.");
+    read_at_(offset, output);
+    decryptor_.decrypt_range(offset, output);
+}
+
+} // namespace cryp
+} // namespace arba
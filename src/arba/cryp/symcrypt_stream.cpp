@@ -0,0 +1,214 @@
+#include <arba/cryp/byte_transform.hpp>
+#include <arba/cryp/symcrypt_stream.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+uint8_t* to_uint8_pointer(std::byte* bytes)
+{
+    return reinterpret_cast<uint8_t*>(bytes);
+}
+
+const uint8_t* to_uint8_pointer(const std::byte* bytes)
+{
+    return reinterpret_cast<const uint8_t*>(bytes);
+}
+} // namespace
+
+// format
+
+std::size_t symcrypt_stream_format::decrypted_data_size(std::size_t body_size, uint8_t size_byte)
+{
+    if (body_size < max_trailer_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: the stream is truncated.");
+    if (size_byte > symcrypt_base::min_data_size)
+        return body_size - 1;
+    // Data smaller than min_data_size are padded up to min_data_size.
+    if (body_size != max_trailer_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: the stream is inconsistent.");
+    return size_byte;
+}
+
+// encoder
+
+symcrypt_encoder::symcrypt_encoder(symcrypt_base& symcrypt)
+    : symcrypt_(&symcrypt), key_schedule_(symcrypt.shared_key_schedule()), offsets_(generate_offsets_(symcrypt)),
+      keystream_(*key_schedule_, offsets_)
+{
+}
+
+std::array<uint8_t, symcrypt_encoder::header_size> symcrypt_encoder::generate_offsets_(symcrypt_base& symcrypt)
+{
+    std::array<uint8_t, header_size> offsets;
+    symcrypt.draw_random_bytes(offsets);
+    return offsets;
+}
+
+std::size_t symcrypt_encoder::update(std::span<const std::byte> input, std::span<std::byte> output)
+{
+    if (finished_) [[unlikely]]
+        throw std::logic_error("symcrypt_encoder: the stream is already finished.");
+    const std::size_t header_output_size = header_is_written_ ? 0 : header_size;
+    if (output.size() < header_output_size + input.size()) [[unlikely]]
+        throw std::invalid_argument("symcrypt_encoder: output is too small.");
+
+    std::size_t output_size = write_header_(output.data());
+    keystream_.encrypt(to_uint8_pointer(input.data()), to_uint8_pointer(output.data() + output_size), input.size(),
+                       data_size_);
+    data_size_ += input.size();
+    return output_size + input.size();
+}
+
+std::size_t symcrypt_encoder::finish(std::span<std::byte> output)
+{
+    if (finished_) [[unlikely]]
+        throw std::logic_error("symcrypt_encoder: the stream is already finished.");
+    // The data are padded so that empty or very small data cannot be guessed,
+    // and size information is stored at the end of data.
+    const std::size_t padding_size =
+        data_size_ < symcrypt_base::min_data_size ? symcrypt_base::min_data_size - data_size_ : 0;
+    const std::size_t header_output_size = header_is_written_ ? 0 : header_size;
+    if (output.size() < header_output_size + padding_size + 1) [[unlikely]]
+        throw std::invalid_argument("symcrypt_encoder: output is too small.");
+
+    std::size_t output_size = write_header_(output.data());
+    uint8_t* trailer = to_uint8_pointer(output.data() + output_size);
+    symcrypt_->draw_random_bytes(std::span(trailer, padding_size));
+    trailer[padding_size] =
+        data_size_ <= symcrypt_base::min_data_size ? static_cast<uint8_t>(data_size_) : symcrypt_base::min_data_size_1;
+    keystream_.encrypt(trailer, trailer, padding_size + 1, data_size_);
+    finished_ = true;
+    return output_size + padding_size + 1;
+}
+
+std::size_t symcrypt_encoder::write_header(std::span<std::byte> output)
+{
+    if (finished_) [[unlikely]]
+        throw std::logic_error("symcrypt_encoder: the stream is already finished.");
+    if (!header_is_written_ && output.size() < header_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt_encoder: output is too small.");
+    return write_header_(output.data());
+}
+
+void symcrypt_encoder::encrypt_at(std::size_t data_index, std::span<const std::byte> input,
+                                  std::span<std::byte> output) const
+{
+    if (output.size() < input.size()) [[unlikely]]
+        throw std::invalid_argument("symcrypt_encoder: output is too small.");
+    keystream_.encrypt(to_uint8_pointer(input.data()), to_uint8_pointer(output.data()), input.size(), data_index);
+}
+
+void symcrypt_encoder::advance(std::size_t size)
+{
+    if (finished_) [[unlikely]]
+        throw std::logic_error("symcrypt_encoder: the stream is already finished.");
+    data_size_ += size;
+}
+
+std::size_t symcrypt_encoder::write_header_(std::byte* output)
+{
+    if (header_is_written_)
+        return 0;
+    // The offsets are hidden with the key hash, as in the block format.
+    const key_schedule::key_hash_bytes_array& key_hash_bytes = key_schedule_->key_hash_bytes();
+    for (std::size_t i = 0; i < header_size; ++i)
+        output[i] = static_cast<std::byte>(offsets_[i] + key_hash_bytes[i]);
+    header_is_written_ = true;
+    return header_size;
+}
+
+// decoder
+
+symcrypt_decoder::symcrypt_decoder(const symcrypt_base& symcrypt) : key_schedule_(symcrypt.shared_key_schedule())
+{
+}
+
+std::size_t symcrypt_decoder::update(std::span<const std::byte> input, std::span<std::byte> output)
+{
+    if (finished_) [[unlikely]]
+        throw std::logic_error("symcrypt_decoder: the stream is already finished.");
+    const std::size_t header_input_size = keystream_ ? 0 : std::min(input.size(), header_size - read_header_size_);
+    const std::size_t available_size = held_size_ + input.size() - header_input_size;
+    const std::size_t output_size = available_size > max_trailer_size ? available_size - max_trailer_size : 0;
+    if (output.size() < output_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt_decoder: output is too small.");
+    input = input.subspan(read_header(input));
+
+    // The last max_trailer_size bytes are held back, the previous ones are decrypted.
+    if (output_size == 0)
+    {
+        std::ranges::copy(input, reinterpret_cast<std::byte*>(held_bytes_.data()) + held_size_);
+        held_size_ = available_size;
+        return 0;
+    }
+
+    uint8_t* output_bytes = to_uint8_pointer(output.data());
+    const std::size_t held_output_size = std::min(output_size, held_size_);
+    keystream_->decrypt(held_bytes_.data(), output_bytes, held_output_size, data_size_);
+    const std::size_t input_output_size = output_size - held_output_size;
+    keystream_->decrypt(to_uint8_pointer(input.data()), output_bytes + held_output_size, input_output_size,
+                        data_size_ + held_output_size);
+    data_size_ += output_size;
+
+    std::copy(held_bytes_.begin() + held_output_size, held_bytes_.begin() + held_size_, held_bytes_.begin());
+    held_size_ -= held_output_size;
+    const uint8_t* input_bytes = to_uint8_pointer(input.data());
+    std::copy(input_bytes + input_output_size, input_bytes + input.size(), held_bytes_.begin() + held_size_);
+    held_size_ = max_trailer_size;
+    return output_size;
+}
+
+std::size_t symcrypt_decoder::finish(std::span<std::byte> output)
+{
+    if (finished_) [[unlikely]]
+        throw std::logic_error("symcrypt_decoder: the stream is already finished.");
+    if (held_size_ < max_trailer_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt_decoder: the stream is truncated.");
+
+    // Size information is retrieved from the last byte.
+    const uint8_t size_byte = decrypt_byte(held_bytes_.back(), (*keystream_)[data_size_ + held_size_ - 1]);
+    const std::size_t output_size = decrypted_data_size(data_size_ + held_size_, size_byte) - data_size_;
+    if (output.size() < output_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt_decoder: output is too small.");
+
+    keystream_->decrypt(held_bytes_.data(), to_uint8_pointer(output.data()), output_size, data_size_);
+    data_size_ += output_size;
+    finished_ = true;
+    return output_size;
+}
+
+void symcrypt_decoder::decrypt_at(std::size_t body_index, std::span<const std::byte> input,
+                                  std::span<std::byte> output) const
+{
+    if (!keystream_) [[unlikely]]
+        throw std::logic_error("symcrypt_decoder: the header is not read.");
+    if (output.size() < input.size()) [[unlikely]]
+        throw std::invalid_argument("symcrypt_decoder: output is too small.");
+    keystream_->decrypt(to_uint8_pointer(input.data()), to_uint8_pointer(output.data()), input.size(), body_index);
+}
+
+std::size_t symcrypt_decoder::read_header(std::span<const std::byte> input)
+{
+    if (keystream_)
+        return 0;
+    const std::size_t read_size = std::min(input.size(), header_size - read_header_size_);
+    std::ranges::copy(input.first(read_size), reinterpret_cast<std::byte*>(header_.data()) + read_header_size_);
+    read_header_size_ += read_size;
+    if (read_header_size_ == header_size)
+    {
+        // Get the offsets, hidden with the key hash.
+        keystream_.emplace(*key_schedule_,
+                           symcrypt_base::retrieve_offsets(*key_schedule_, std::as_bytes(std::span(header_))));
+    }
+    return read_size;
+}
+
+} // namespace cryp
+} // namespace arba
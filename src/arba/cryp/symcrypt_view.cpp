@@ -0,0 +1,62 @@
+#include <arba/cryp/symcrypt_view.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+void check_range(std::size_t offset, std::size_t size, std::size_t view_size)
+{
+    if (offset > view_size || size > view_size - offset) [[unlikely]]
+        throw std::out_of_range("symcrypt: the range ends after the view.");
+}
+} // namespace
+
+// decrypted view
+
+decrypted_view::decrypted_view(const symcrypt_base& symcrypt, std::span<const std::byte> ciphertext)
+{
+    if (ciphertext.size() < symcrypt_base::min_encrypted_size) [[unlikely]]
+        throw std::invalid_argument("symcrypt: encrypted data are too small.");
+    source_ = std::make_shared<const source>(
+        symcrypt_range_decryptor(symcrypt, ciphertext.last<symcrypt_base::trailer_size>(), ciphertext.size()),
+        ciphertext);
+}
+
+void decrypted_view::copy_to(std::size_t offset, std::span<std::byte> output) const
+{
+    check_range(offset, output.size(), size());
+    if (!output.empty())
+        source_->decryptor.decrypt_range(offset, source_->ciphertext.subspan(offset, output.size()), output);
+}
+
+// encrypted view
+
+encrypted_view::encrypted_view(symcrypt_base& symcrypt, std::span<const std::byte> data)
+    : source_(std::make_shared<const source>(symcrypt_range_encryptor(symcrypt, data.size()), data))
+{
+}
+
+void encrypted_view::copy_to(std::size_t offset, std::span<std::byte> output) const
+{
+    check_range(offset, output.size(), size());
+    // The data part, then the trailer part.
+    const std::size_t data_size = source_ ? source_->data.size() : 0;
+    if (offset < data_size)
+    {
+        const std::size_t size = std::min(output.size(), data_size - offset);
+        source_->encryptor.encrypt_range(offset, source_->data.subspan(offset, size), output);
+        output = output.subspan(size);
+        offset += size;
+    }
+    if (!output.empty())
+        std::ranges::copy(source_->encryptor.trailer().subspan(offset - data_size, output.size()), output.begin());
+}
+
+} // namespace cryp
+} // namespace arba
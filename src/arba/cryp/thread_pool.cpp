@@ -0,0 +1,207 @@
+#include <arba/cryp/thread_pool.hpp>
+
+#include <exception>
+#include <limits>
+
+inline namespace arba
+{
+namespace cryp
+{
+
+namespace
+{
+constexpr std::size_t no_worker_index = std::numeric_limits<std::size_t>::max();
+
+thread_local const thread_pool* current_thread_pool = nullptr;
+thread_local std::size_t current_thread_worker_index = no_worker_index;
+
+struct bulk_state
+{
+    explicit bulk_state(std::size_t task_count) : remaining_task_count(task_count) {}
+
+    std::size_t remaining_task_count;
+    std::mutex mutex;
+    std::condition_variable done_condition;
+    std::exception_ptr exception;
+};
+
+void run_bulk_task(bulk_state& state, const std::function<void(std::size_t)>& task, std::size_t task_index)
+{
+    std::exception_ptr exception;
+    try
+    {
+        task(task_index);
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    std::lock_guard lock(state.mutex);
+    if (exception && !state.exception)
+        state.exception = exception;
+    if (--state.remaining_task_count == 0)
+        state.done_condition.notify_all();
+}
+
+// An exception thrown by a submitted task must neither stop a worker nor leave a bulk_execute() helping the workers
+// before its own tasks are done: it is dropped.
+void run_submitted_task(const thread_pool::task_type& task)
+{
+    try
+    {
+        task();
+    }
+    catch (...)
+    {
+    }
+}
+} // namespace
+
+thread_pool::thread_pool(std::size_t thread_count)
+{
+    queues_.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; ++i)
+        queues_.push_back(std::make_unique<task_queue>());
+    workers_.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; ++i)
+        workers_.emplace_back(&thread_pool::run_worker_, this, i);
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    sleep_condition_.notify_all();
+    for (std::thread& worker : workers_)
+        worker.join();
+}
+
+std::size_t thread_pool::concurrency() const
+{
+    return workers_.size();
+}
+
+void thread_pool::bulk_execute(std::size_t task_count, const std::function<void(std::size_t)>& task)
+{
+    if (workers_.empty() || task_count <= 1)
+    {
+        for (std::size_t task_index = 0; task_index < task_count; ++task_index)
+            task(task_index);
+        return;
+    }
+
+    bulk_state state(task_count);
+    for (std::size_t task_index = 1; task_index < task_count; ++task_index)
+        submit([&state, &task, task_index] { run_bulk_task(state, task, task_index); });
+    run_bulk_task(state, task, 0);
+
+    // Help the workers while tasks are queued, then wait for the tasks run by the workers.
+    const std::size_t worker_index = current_worker_index_();
+    for (;;)
+    {
+        {
+            std::lock_guard lock(state.mutex);
+            if (state.remaining_task_count == 0)
+                break;
+        }
+        std::optional<task_type> queued_task = try_pop_task_(worker_index);
+        if (!queued_task)
+        {
+            std::unique_lock lock(state.mutex);
+            state.done_condition.wait(lock, [&state] { return state.remaining_task_count == 0; });
+            break;
+        }
+        run_submitted_task(*queued_task);
+    }
+
+    if (state.exception)
+        std::rethrow_exception(state.exception);
+}
+
+void thread_pool::submit(task_type task)
+{
+    if (workers_.empty()) [[unlikely]]
+    {
+        run_submitted_task(task);
+        return;
+    }
+
+    std::size_t queue_index = current_worker_index_();
+    if (queue_index == no_worker_index)
+        queue_index = next_queue_index_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        task_queue& queue = *queues_[queue_index];
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+        ++pending_task_count_;
+    }
+    // Synchronize with the workers checking pending_task_count_ before going to sleep, so no wake-up is lost.
+    {
+        std::lock_guard lock(sleep_mutex_);
+    }
+    sleep_condition_.notify_one();
+}
+
+void thread_pool::run_worker_(std::size_t worker_index)
+{
+    current_thread_pool = this;
+    current_thread_worker_index = worker_index;
+
+    for (;;)
+    {
+        if (std::optional<task_type> task = try_pop_task_(worker_index))
+        {
+            run_submitted_task(*task);
+            continue;
+        }
+
+        std::unique_lock lock(sleep_mutex_);
+        sleep_condition_.wait(lock, [this] { return stopping_ || pending_task_count_ > 0; });
+        if (stopping_ && pending_task_count_ == 0)
+            return;
+    }
+}
+
+std::optional<thread_pool::task_type> thread_pool::try_pop_task_(std::size_t worker_index)
+{
+    // The worker runs its own most recent task first.
+    if (worker_index != no_worker_index)
+    {
+        task_queue& queue = *queues_[worker_index];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task_type task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            --pending_task_count_;
+            return task;
+        }
+    }
+
+    // Otherwise, it steals the oldest task of another worker.
+    const std::size_t first_index = worker_index == no_worker_index ? 0 : worker_index + 1;
+    for (std::size_t i = 0; i < queues_.size(); ++i)
+    {
+        task_queue& queue = *queues_[(first_index + i) % queues_.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task_type task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            --pending_task_count_;
+            return task;
+        }
+    }
+    return std::nullopt;
+}
+
+std::size_t thread_pool::current_worker_index_() const
+{
+    return current_thread_pool == this ? current_thread_worker_index : no_worker_index;
+}
+
+} // namespace cryp
+} // namespace arba
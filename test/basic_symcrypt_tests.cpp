@@ -0,0 +1,69 @@
+#include <arba/cryp/basic_symcrypt.hpp>
+#include <arba/cryp/symcrypt.hpp>
+
+#include <arba/rand/urng.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+struct urng_bytes_generator
+{
+    explicit urng_bytes_generator(unsigned seed) : rng(seed) {}
+
+    void operator()(std::span<uint8_t> bytes)
+    {
+        ++call_count;
+        std::ranges::generate(bytes, std::ref(rng));
+    }
+
+    rand::urng_u8<0, 255> rng;
+    std::size_t call_count = 0;
+};
+
+const cryp::symcrypt_base::crypto_key key{ 0xa8, 0x69, 0xad, 0x09, 0x1e, 0x02, 0x45, 0x2b,
+                                           0x81, 0xc8, 0x2e, 0xfc, 0x5d, 0xfa, 0x24, 0xad };
+} // namespace
+
+TEST(basic_symcrypt_tests, test_default_generator)
+{
+    cryp::basic_symcrypt<> symcrypt(key);
+    ASSERT_EQ(symcrypt.key(), key);
+    for (std::size_t size : { 0, 1, 16, 17, 1000 })
+    {
+        std::vector<uint8_t> init_data(size, 7);
+        std::vector<uint8_t> data = init_data;
+        symcrypt.encrypt(data);
+        ASSERT_NE(data, init_data);
+        std::vector<uint8_t> second_data = init_data;
+        symcrypt.encrypt(second_data);
+        ASSERT_NE(data, second_data);
+        symcrypt.decrypt(data);
+        ASSERT_EQ(data, init_data);
+    }
+}
+
+TEST(basic_symcrypt_tests, test_one_generator_call_per_encryption)
+{
+    cryp::basic_symcrypt<urng_bytes_generator> symcrypt(key, urng_bytes_generator(42));
+    std::vector<uint8_t> data{ 0, 1 };
+    symcrypt.encrypt(data);
+    ASSERT_EQ(symcrypt.random_bytes_generator().call_count, 1);
+    symcrypt.decrypt(data);
+    ASSERT_EQ(symcrypt.random_bytes_generator().call_count, 1);
+}
+
+TEST(basic_symcrypt_tests, test_same_output_as_symcrypt)
+{
+    for (std::size_t size : { 0, 2, 16, 17, 20, 5000 })
+    {
+        std::vector<uint8_t> data(size);
+        std::ranges::generate(data, rand::urng_u8<0, 255>(7));
+        std::vector<uint8_t> expected_data = data;
+        cryp::symcrypt(key, rand::urng_u8<0, 255>(42)).encrypt(expected_data);
+        cryp::basic_symcrypt<urng_bytes_generator>(key, urng_bytes_generator(42)).encrypt(data);
+        ASSERT_EQ(data, expected_data);
+    }
+}
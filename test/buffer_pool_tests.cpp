@@ -0,0 +1,71 @@
+#include <arba/cryp/buffer_pool.hpp>
+#include <arba/cryp/symcrypt.hpp>
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <vector>
+
+TEST(buffer_pool_tests, test_acquire)
+{
+    cryp::buffer_pool pool(2);
+    const uint8_t* data = nullptr;
+    {
+        cryp::buffer_pool::buffer buffer = pool.acquire(100);
+        ASSERT_TRUE(buffer->empty());
+        ASSERT_GE(buffer->capacity(), cryp::symcrypt::encrypted_size(100));
+        data = buffer->data();
+        ASSERT_EQ(pool.size(), 0);
+    }
+    ASSERT_EQ(pool.size(), 1);
+
+    // The pooled buffer is reused for smaller data, not for larger data.
+    {
+        cryp::buffer_pool::buffer buffer = pool.acquire(50);
+        ASSERT_EQ(buffer->data(), data);
+        ASSERT_EQ(pool.size(), 0);
+        cryp::buffer_pool::buffer other_buffer = pool.acquire(1000);
+        ASSERT_NE(other_buffer->data(), data);
+        ASSERT_GE(other_buffer->capacity(), cryp::symcrypt::encrypted_size(1000));
+    }
+    ASSERT_EQ(pool.size(), 2);
+
+    // The smallest large enough buffer is chosen.
+    {
+        cryp::buffer_pool::buffer buffer = pool.acquire(10);
+        ASSERT_EQ(buffer->data(), data);
+    }
+
+    // A full pool keeps the largest buffers.
+    {
+        cryp::buffer_pool::buffer buffer = pool.acquire(5000);
+    }
+    ASSERT_EQ(pool.size(), 2);
+    {
+        cryp::buffer_pool::buffer buffer = pool.acquire(2000);
+        ASSERT_GE(buffer->capacity(), cryp::symcrypt::encrypted_size(5000));
+        ASSERT_LT(pool.acquire(1000)->capacity(), cryp::symcrypt::encrypted_size(5000));
+    }
+
+    pool.clear();
+    ASSERT_EQ(pool.size(), 0);
+}
+
+TEST(buffer_pool_tests, test_encrypt_without_reallocation)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    for (std::size_t data_size : { 0, 10, 16, 17, 1000 })
+    {
+        std::vector<uint8_t> data(data_size);
+        std::iota(data.begin(), data.end(), 0);
+        cryp::buffer_pool::buffer buffer = cryp::buffer_pool::local().acquire(data_size);
+        buffer->assign(data.begin(), data.end());
+        const uint8_t* buffer_data = buffer->data();
+        symcrypt.encrypt(*buffer);
+        ASSERT_EQ(buffer->data(), buffer_data);
+        ASSERT_EQ(buffer->size(), cryp::symcrypt::encrypted_size(data_size));
+        symcrypt.decrypt(*buffer);
+        ASSERT_EQ(*buffer, data);
+    }
+    ASSERT_GE(cryp::buffer_pool::local().size(), 1);
+}
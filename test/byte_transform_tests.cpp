@@ -0,0 +1,144 @@
+#include <arba/cryp/byte_transform.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+std::vector<uint8_t> random_bytes(std::size_t size, unsigned seed)
+{
+    std::mt19937 engine(seed);
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t& byte : bytes)
+        byte = static_cast<uint8_t>(engine());
+    return bytes;
+}
+
+const std::vector<cryp::instruction_set> instruction_sets{ cryp::instruction_set::scalar, cryp::instruction_set::sse4,
+                                                           cryp::instruction_set::avx2, cryp::instruction_set::avx512 };
+} // namespace
+
+TEST(byte_transform_tests, test_encrypt_decrypt_byte)
+{
+    for (unsigned byte = 0; byte < 256; ++byte)
+    {
+        for (unsigned crypto_offset = 0; crypto_offset < 256; ++crypto_offset)
+        {
+            uint8_t encrypted_byte = cryp::encrypt_byte(byte, crypto_offset);
+            ASSERT_EQ(cryp::decrypt_byte(encrypted_byte, crypto_offset), byte);
+        }
+    }
+}
+
+TEST(byte_transform_tests, test_scalar_is_always_supported)
+{
+    ASSERT_TRUE(cryp::instruction_set_is_supported(cryp::instruction_set::scalar));
+    ASSERT_TRUE(cryp::instruction_set_is_supported(cryp::best_instruction_set()));
+}
+
+TEST(byte_transform_tests, test_instruction_sets_match_scalar)
+{
+    for (std::size_t size : { 0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 1000, 2304 })
+    {
+        const std::vector<uint8_t> input = random_bytes(size, 1);
+        const std::vector<uint8_t> crypto_offsets = random_bytes(size, 2);
+        std::vector<uint8_t> expected_encrypted(size);
+        std::vector<uint8_t> expected_decrypted(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            expected_encrypted[i] = cryp::encrypt_byte(input[i], crypto_offsets[i]);
+            expected_decrypted[i] = cryp::decrypt_byte(input[i], crypto_offsets[i]);
+        }
+
+        for (cryp::instruction_set iset : instruction_sets)
+        {
+            if (!cryp::instruction_set_is_supported(iset))
+                continue;
+            std::vector<uint8_t> output(size);
+            cryp::encrypt_bytes(input.data(), output.data(), crypto_offsets.data(), size, iset);
+            ASSERT_EQ(output, expected_encrypted) << cryp::to_string_view(iset) << " " << size;
+            cryp::decrypt_bytes(input.data(), output.data(), crypto_offsets.data(), size, iset);
+            ASSERT_EQ(output, expected_decrypted) << cryp::to_string_view(iset) << " " << size;
+        }
+    }
+}
+
+TEST(byte_transform_tests, test_in_place_round_trip)
+{
+    const std::vector<uint8_t> input = random_bytes(4096 + 7, 3);
+    const std::vector<uint8_t> crypto_offsets = random_bytes(input.size(), 4);
+    std::vector<uint8_t> bytes = input;
+    cryp::encrypt_bytes(bytes.data(), bytes.data(), crypto_offsets.data(), bytes.size());
+    ASSERT_NE(bytes, input);
+    cryp::decrypt_bytes(bytes.data(), bytes.data(), crypto_offsets.data(), bytes.size());
+    ASSERT_EQ(bytes, input);
+}
+
+TEST(byte_transform_tests, test_reencrypt_matches_decrypt_encrypt)
+{
+    for (std::size_t size : { 0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 1000, 2304 })
+    {
+        const std::vector<uint8_t> input = random_bytes(size, 5);
+        const std::vector<uint8_t> old_offsets = random_bytes(size, 6);
+        const std::vector<uint8_t> new_offsets = random_bytes(size, 7);
+        std::vector<uint8_t> expected(size);
+        for (std::size_t i = 0; i < size; ++i)
+            expected[i] = cryp::encrypt_byte(cryp::decrypt_byte(input[i], old_offsets[i]), new_offsets[i]);
+
+        for (cryp::instruction_set iset : instruction_sets)
+        {
+            if (!cryp::instruction_set_is_supported(iset))
+                continue;
+            std::vector<uint8_t> output(size);
+            cryp::reencrypt_bytes(input.data(), output.data(), old_offsets.data(), new_offsets.data(), size, iset);
+            ASSERT_EQ(output, expected) << cryp::to_string_view(iset) << " " << size;
+            output = input;
+            cryp::reencrypt_bytes(output.data(), output.data(), old_offsets.data(), new_offsets.data(), size, iset);
+            ASSERT_EQ(output, expected) << cryp::to_string_view(iset) << " " << size;
+        }
+        std::vector<uint8_t> output(size);
+        cryp::reencrypt_bytes(input.data(), output.data(), old_offsets.data(), new_offsets.data(), size,
+                              cryp::byte_transform_mode::lookup_table);
+        ASSERT_EQ(output, expected) << size;
+    }
+}
+
+TEST(byte_transform_tests, test_lookup_table_matches_arithmetic)
+{
+    std::vector<uint8_t> input(256 * 256);
+    std::vector<uint8_t> crypto_offsets(input.size());
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = static_cast<uint8_t>(i % 256);
+        crypto_offsets[i] = static_cast<uint8_t>(i / 256);
+    }
+    for (cryp::byte_transform_mode mode :
+         { cryp::byte_transform_mode::arithmetic, cryp::byte_transform_mode::lookup_table })
+    {
+        std::vector<uint8_t> output(input.size());
+        cryp::encrypt_bytes(input.data(), output.data(), crypto_offsets.data(), input.size(), mode);
+        for (std::size_t i = 0; i < input.size(); ++i)
+            ASSERT_EQ(output[i], cryp::encrypt_byte(input[i], crypto_offsets[i])) << cryp::to_string_view(mode);
+        cryp::decrypt_bytes(input.data(), output.data(), crypto_offsets.data(), input.size(), mode);
+        for (std::size_t i = 0; i < input.size(); ++i)
+            ASSERT_EQ(output[i], cryp::decrypt_byte(input[i], crypto_offsets[i])) << cryp::to_string_view(mode);
+    }
+}
+
+TEST(byte_transform_tests, test_default_byte_transform_mode)
+{
+    ASSERT_EQ(cryp::default_byte_transform_mode(), cryp::byte_transform_mode::arithmetic);
+    const std::vector<uint8_t> input = random_bytes(1000, 5);
+    const std::vector<uint8_t> crypto_offsets = random_bytes(input.size(), 6);
+    std::vector<uint8_t> expected_output(input.size());
+    cryp::encrypt_bytes(input.data(), expected_output.data(), crypto_offsets.data(), input.size());
+
+    cryp::set_default_byte_transform_mode(cryp::byte_transform_mode::lookup_table);
+    ASSERT_EQ(cryp::default_byte_transform_mode(), cryp::byte_transform_mode::lookup_table);
+    std::vector<uint8_t> output(input.size());
+    cryp::encrypt_bytes(input.data(), output.data(), crypto_offsets.data(), input.size());
+    cryp::set_default_byte_transform_mode(cryp::byte_transform_mode::arithmetic);
+    ASSERT_EQ(output, expected_output);
+}
@@ -0,0 +1,55 @@
+#include <arba/cryp/execution_policy.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace
+{
+std::size_t hardware_thread_count()
+{
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+std::size_t expected_parallel_thread_count(std::size_t max_thread_count)
+{
+    return max_thread_count == 0 ? hardware_thread_count() : std::min(max_thread_count, hardware_thread_count());
+}
+} // namespace
+
+TEST(execution_policy_tests, test_sequential)
+{
+    constexpr cryp::execution_policy policy = cryp::execution_policy::sequential();
+    static_assert(policy.execution_mode() == cryp::execution_policy::mode::sequential);
+    ASSERT_EQ(policy.thread_count(0), 1);
+    ASSERT_EQ(policy.thread_count(1024 * 1024 * 1024), 1);
+}
+
+TEST(execution_policy_tests, test_parallel)
+{
+    constexpr cryp::execution_policy policy = cryp::execution_policy::parallel();
+    static_assert(policy.execution_mode() == cryp::execution_policy::mode::parallel);
+    ASSERT_EQ(policy.thread_count(1), expected_parallel_thread_count(0));
+    constexpr cryp::execution_policy capped_policy = cryp::execution_policy::parallel(2);
+    static_assert(capped_policy.max_thread_count() == 2);
+    ASSERT_EQ(capped_policy.thread_count(1), expected_parallel_thread_count(2));
+}
+
+TEST(execution_policy_tests, test_automatic)
+{
+    constexpr cryp::execution_policy policy = cryp::execution_policy::automatic(4096, 3);
+    static_assert(policy.execution_mode() == cryp::execution_policy::mode::automatic);
+    static_assert(policy.parallel_threshold() == 4096);
+    static_assert(policy.max_thread_count() == 3);
+    ASSERT_EQ(policy.thread_count(4095), 1);
+    ASSERT_EQ(policy.thread_count(4096), expected_parallel_thread_count(3));
+}
+
+TEST(execution_policy_tests, test_bool)
+{
+    constexpr cryp::execution_policy parallel_policy = true;
+    static_assert(parallel_policy.execution_mode() == cryp::execution_policy::mode::automatic);
+    static_assert(parallel_policy.parallel_threshold() == cryp::execution_policy::default_parallel_threshold);
+    constexpr cryp::execution_policy sequential_policy = false;
+    static_assert(sequential_policy.execution_mode() == cryp::execution_policy::mode::sequential);
+}
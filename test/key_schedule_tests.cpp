@@ -0,0 +1,46 @@
+#include <arba/cryp/key_schedule.hpp>
+#include <arba/cryp/keystream.hpp>
+#include <arba/cryp/symcrypt.hpp>
+
+#include <arba/hash/murmur_hash.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+const cryp::key_schedule::crypto_key key{ 0xa8, 0x69, 0xad, 0x09, 0x1e, 0x02, 0x45, 0x2b,
+                                          0x81, 0xc8, 0x2e, 0xfc, 0x5d, 0xfa, 0x24, 0xad };
+} // namespace
+
+TEST(key_schedule_tests, test_key_hash_bytes)
+{
+    cryp::key_schedule schedule(key);
+    ASSERT_EQ(schedule.key(), key);
+    uint64_t key_hash = hash::neutral_murmur_hash_64(key.data(), key.size());
+    for (uint8_t byte : schedule.key_hash_bytes())
+    {
+        ASSERT_EQ(byte, key_hash % 256);
+        key_hash /= 256;
+    }
+}
+
+TEST(key_schedule_tests, test_keystream)
+{
+    cryp::key_schedule schedule(key);
+    const std::array<uint8_t, 8> offs{ 0x3b, 0x9f, 0x87, 0x00, 0xff, 0x86, 0x2f, 0x3d };
+    cryp::keystream expected_kstream(key, offs);
+    cryp::keystream kstream(schedule, offs);
+    ASSERT_EQ(kstream.size(), expected_kstream.size());
+    ASSERT_TRUE(std::equal(kstream.data(), kstream.data() + kstream.size(), expected_kstream.data()));
+}
+
+TEST(key_schedule_tests, test_symcrypt_key_schedule)
+{
+    cryp::symcrypt symcrypt(key);
+    std::shared_ptr<const cryp::key_schedule> schedule = symcrypt.shared_key_schedule();
+    ASSERT_EQ(schedule->key(), key);
+    cryp::symcrypt symcrypt_copy = symcrypt;
+    ASSERT_EQ(symcrypt_copy.shared_key_schedule(), schedule);
+    symcrypt_copy.set_key(std::string_view("other password"));
+    ASSERT_NE(symcrypt_copy.shared_key_schedule(), schedule);
+    ASSERT_EQ(symcrypt.shared_key_schedule(), schedule);
+}
@@ -0,0 +1,230 @@
+#include <arba/cryp/executor.hpp>
+#include <arba/cryp/keyring.hpp>
+#include <arba/cryp/symcrypt.hpp>
+#include <arba/cryp/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(keyring_tests, test_insert_find_erase)
+{
+    cryp::keyring keyring;
+    ASSERT_EQ(keyring.size(), 0);
+    ASSERT_EQ(keyring.find("tenant-1"), nullptr);
+
+    keyring.insert_or_assign("tenant-1", std::string_view("password 1"));
+    const cryp::keyring::crypto_key key{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+    keyring.insert_or_assign("tenant-2", key);
+    ASSERT_EQ(keyring.size(), 2);
+    ASSERT_TRUE(keyring.contains("tenant-1"));
+    ASSERT_EQ(keyring.find("tenant-1")->key(), cryp::symcrypt_base::to_crypto_key("password 1"));
+    ASSERT_EQ(keyring.find("tenant-2")->key(), key);
+
+    // A found key schedule stays valid when its key is replaced or erased.
+    std::shared_ptr<const cryp::key_schedule> schedule = keyring.find("tenant-1");
+    keyring.insert_or_assign("tenant-1", std::string_view("password 3"));
+    ASSERT_EQ(schedule->key(), cryp::symcrypt_base::to_crypto_key("password 1"));
+    ASSERT_NE(keyring.find("tenant-1"), schedule);
+    ASSERT_TRUE(keyring.erase("tenant-1"));
+    ASSERT_FALSE(keyring.erase("tenant-1"));
+    ASSERT_FALSE(keyring.contains("tenant-1"));
+    ASSERT_EQ(keyring.size(), 1);
+    ASSERT_EQ(schedule->key(), cryp::symcrypt_base::to_crypto_key("password 1"));
+}
+
+TEST(keyring_tests, test_release_erased_keys)
+{
+    // The threads which looked up the keys, like the workers of a thread pool, do not keep them alive.
+    cryp::thread_pool pool(4);
+    std::unique_ptr<cryp::keyring> keyring = std::make_unique<cryp::keyring>();
+    keyring->insert_or_assign("tenant-1", std::string_view("password 1"));
+    keyring->insert_or_assign("tenant-2", std::string_view("password 2"));
+    const auto look_up = [&](std::string_view key_id)
+    {
+        pool.bulk_execute(16, [&](std::size_t) { EXPECT_TRUE(keyring->contains(key_id)); });
+        ASSERT_TRUE(keyring->contains(key_id));
+    };
+
+    look_up("tenant-1");
+    std::shared_ptr<const cryp::key_schedule> schedule = keyring->find("tenant-1");
+    ASSERT_EQ(schedule.use_count(), 2);
+    ASSERT_TRUE(keyring->erase("tenant-1"));
+    ASSERT_EQ(schedule.use_count(), 1);
+
+    look_up("tenant-2");
+    schedule = keyring->find("tenant-2");
+    ASSERT_EQ(schedule.use_count(), 2);
+    keyring.reset();
+    ASSERT_EQ(schedule.use_count(), 1);
+}
+
+TEST(keyring_tests, test_encrypt_decrypt)
+{
+    cryp::keyring keyring;
+    keyring.insert_or_assign("tenant-1", std::string_view("password 1"));
+    keyring.insert_or_assign("tenant-2", std::string_view("password 2"));
+
+    std::vector<uint8_t> data(100);
+    std::iota(data.begin(), data.end(), 0);
+    std::vector<uint8_t> bytes = data;
+    keyring.encrypt("tenant-1", bytes);
+    ASSERT_EQ(bytes.size(), cryp::symcrypt::encrypted_size(data.size()));
+
+    // The keyring encryption is the one of a symcrypt with the same password.
+    std::vector<uint8_t> decrypted_bytes = bytes;
+    cryp::symcrypt symcrypt(std::string_view("password 1"));
+    symcrypt.decrypt(decrypted_bytes);
+    ASSERT_EQ(decrypted_bytes, data);
+    keyring.decrypt("tenant-1", bytes);
+    ASSERT_EQ(bytes, data);
+
+    std::vector<std::byte> encrypted(cryp::symcrypt::encrypted_size(data.size()));
+    ASSERT_EQ(keyring.encrypt("tenant-2", std::as_bytes(std::span(data)), encrypted), encrypted.size());
+    std::vector<std::byte> decrypted(encrypted.size());
+    ASSERT_EQ(keyring.decrypt("tenant-2", encrypted, decrypted), data.size());
+    ASSERT_TRUE(std::ranges::equal(std::span(decrypted).first(data.size()), std::as_bytes(std::span(data))));
+    ASSERT_EQ(keyring.symcrypt("tenant-2").key(), cryp::symcrypt_base::to_crypto_key("password 2"));
+
+    ASSERT_THROW(keyring.encrypt("tenant-3", bytes), std::out_of_range);
+    ASSERT_THROW(keyring.symcrypt("tenant-3"), std::out_of_range);
+}
+
+TEST(keyring_tests, test_concurrent_lookups)
+{
+    cryp::keyring keyring;
+    for (int i = 0; i < 10; ++i)
+        keyring.insert_or_assign("tenant-" + std::to_string(i), "password " + std::to_string(i));
+
+    std::vector<std::thread> threads;
+    std::atomic_int error_count = 0;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            [&keyring, &error_count, t]
+            {
+                for (int i = 0; i < 200; ++i)
+                {
+                    const std::string key_id = "tenant-" + std::to_string((t + i) % 10);
+                    std::vector<uint8_t> data(50, static_cast<uint8_t>(i));
+                    std::vector<uint8_t> bytes = data;
+                    keyring.encrypt(key_id, bytes);
+                    keyring.decrypt(key_id, bytes);
+                    if (bytes != data)
+                        ++error_count;
+                }
+            });
+    }
+    // Keys are added and erased meanwhile.
+    for (int i = 0; i < 100; ++i)
+    {
+        keyring.insert_or_assign("other-tenant-" + std::to_string(i), std::string_view("password"));
+        keyring.erase("other-tenant-" + std::to_string(i - 1));
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    ASSERT_EQ(error_count, 0);
+    ASSERT_EQ(keyring.size(), 11);
+}
+
+TEST(keyring_tests, test_symcrypt_key_schedule)
+{
+    cryp::symcrypt symcrypt(std::string_view("password 1"));
+    cryp::keyring keyring;
+    keyring.insert_or_assign("tenant-1", std::string_view("password 2"));
+    symcrypt.set_key_schedule(keyring.find("tenant-1"));
+    ASSERT_EQ(symcrypt.shared_key_schedule(), keyring.find("tenant-1"));
+    ASSERT_THROW(symcrypt.set_key_schedule(nullptr), std::invalid_argument);
+}
+
+TEST(keyring_tests, test_several_keyrings)
+{
+    // More keyrings than the snapshots cached by a thread.
+    std::vector<std::unique_ptr<cryp::keyring>> keyrings;
+    for (int i = 0; i < 6; ++i)
+    {
+        keyrings.push_back(std::make_unique<cryp::keyring>());
+        keyrings.back()->insert_or_assign("tenant", "password " + std::to_string(i));
+    }
+    for (int round = 0; round < 3; ++round)
+        for (int i = 0; i < 6; ++i)
+            ASSERT_EQ(keyrings[i]->find("tenant")->key(),
+                      cryp::symcrypt_base::to_crypto_key("password " + std::to_string(i)));
+
+    // A new keyring does not see the snapshot of a destroyed one.
+    keyrings.front() = std::make_unique<cryp::keyring>();
+    ASSERT_FALSE(keyrings.front()->contains("tenant"));
+    ASSERT_EQ(keyrings.front()->size(), 0);
+}
+
+namespace
+{
+// Executor which updates a keyring and looks up keys in other keyrings before running the tasks of an encryption.
+class nesting_executor : public cryp::executor
+{
+public:
+    nesting_executor(cryp::keyring& keyring, std::vector<std::unique_ptr<cryp::keyring>>& other_keyrings)
+        : keyring_(keyring), other_keyrings_(other_keyrings)
+    {
+    }
+
+    std::size_t concurrency() const override { return 3; }
+
+    void bulk_execute(std::size_t task_count, const std::function<void(std::size_t)>& task) override
+    {
+        if (++call_count == 1)
+        {
+            keyring_.insert_or_assign("tenant-1", "password 2");
+            // More lookups of new snapshots than the snapshots cached by a thread.
+            for (std::unique_ptr<cryp::keyring>& other_keyring : other_keyrings_)
+                EXPECT_TRUE(other_keyring->contains("tenant"));
+            EXPECT_EQ(keyring_.find("tenant-1")->key(), cryp::symcrypt_base::to_crypto_key("password 2"));
+        }
+        for (std::size_t task_index = 0; task_index < task_count; ++task_index)
+            task(task_index);
+    }
+
+    int call_count = 0;
+
+private:
+    cryp::keyring& keyring_;
+    std::vector<std::unique_ptr<cryp::keyring>>& other_keyrings_;
+};
+} // namespace
+
+TEST(keyring_tests, test_nested_lookup_after_update)
+{
+    cryp::keyring keyring;
+    keyring.insert_or_assign("tenant-1", "password 1");
+    std::vector<std::unique_ptr<cryp::keyring>> other_keyrings;
+    for (int i = 0; i < 6; ++i)
+    {
+        other_keyrings.push_back(std::make_unique<cryp::keyring>());
+        other_keyrings.back()->insert_or_assign("tenant", "password");
+    }
+
+    std::vector<uint8_t> data(1024 * 1024);
+    if (cryp::execution_policy::parallel().thread_count(data.size()) <= 1)
+        GTEST_SKIP() << "The encryption runs on one thread: it does not call the executor.";
+    std::iota(data.begin(), data.end(), 0);
+    std::vector<uint8_t> bytes = data;
+    cryp::executor& previous_executor = cryp::default_executor();
+    nesting_executor executor(keyring, other_keyrings);
+    cryp::set_default_executor(executor);
+    keyring.encrypt("tenant-1", bytes, cryp::execution_policy::parallel());
+    cryp::set_default_executor(previous_executor);
+    ASSERT_GE(executor.call_count, 1);
+
+    // The encryption kept using the key schedule it started with.
+    cryp::symcrypt symcrypt(std::string_view("password 1"));
+    symcrypt.decrypt(bytes);
+    ASSERT_EQ(bytes, data);
+}
@@ -0,0 +1,38 @@
+#include <arba/cryp/keystream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+namespace
+{
+constexpr std::array<uint8_t, 16> key{ 0xa8, 0x69, 0xad, 0x09, 0x1e, 0x02, 0x45, 0x2b,
+                                       0x81, 0xc8, 0x2e, 0xfc, 0x5d, 0xfa, 0x24, 0xad };
+constexpr std::array<uint8_t, 8> offs{ 0x3b, 0x9f, 0x87, 0x00, 0xff, 0x86, 0x2f, 0x3d };
+
+uint8_t expected_crypto_offset(std::size_t byte_index)
+{
+    uint8_t key_byte = key[byte_index % key.size()];
+    std::size_t offset_index = key.back() + byte_index + (byte_index / (offs.size() + 1));
+    uint8_t offset = offs[offset_index % offs.size()];
+    offset += static_cast<uint8_t>(byte_index % 256);
+    offset += key_byte;
+    return offset;
+}
+} // namespace
+
+TEST(keystream_tests, test_short_keystream)
+{
+    cryp::keystream kstream(key, offs, 20);
+    ASSERT_EQ(kstream.size(), 20);
+    for (std::size_t i = 0; i < kstream.size(); ++i)
+        ASSERT_EQ(kstream[i], expected_crypto_offset(i)) << i;
+}
+
+TEST(keystream_tests, test_long_keystream)
+{
+    cryp::keystream kstream(key, offs, 1024 * 1024);
+    ASSERT_EQ(kstream.size(), cryp::keystream::period);
+    for (std::size_t i = 0; i < 4 * cryp::keystream::period + 17; ++i)
+        ASSERT_EQ(kstream[i], expected_crypto_offset(i)) << i;
+}
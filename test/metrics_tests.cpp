@@ -0,0 +1,74 @@
+#include <arba/cryp/config.hpp>
+#include <arba/cryp/metrics.hpp>
+#include <arba/cryp/symcrypt.hpp>
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <vector>
+
+namespace
+{
+uint64_t total_count(const cryp::histogram_metrics_sink::histogram& histogram)
+{
+    return std::accumulate(histogram.begin(), histogram.end(), uint64_t(0));
+}
+} // namespace
+
+TEST(metrics_tests, test_histogram_metrics_sink)
+{
+    cryp::histogram_metrics_sink sink;
+    sink.add(cryp::metric_counter::encrypted_bytes, 10);
+    sink.add(cryp::metric_counter::encrypted_bytes, 5);
+    ASSERT_EQ(sink.counter(cryp::metric_counter::encrypted_bytes), 15);
+    ASSERT_EQ(sink.counter(cryp::metric_counter::decrypted_bytes), 0);
+
+    sink.record(cryp::metric_phase::transform, std::chrono::nanoseconds(0));
+    sink.record(cryp::metric_phase::transform, std::chrono::nanoseconds(1));
+    sink.record(cryp::metric_phase::transform, std::chrono::nanoseconds(1000));
+    sink.record(cryp::metric_phase::transform, std::chrono::hours(1000));
+    cryp::histogram_metrics_sink::histogram histogram = sink.phase_histogram(cryp::metric_phase::transform);
+    ASSERT_EQ(histogram[0], 2);
+    ASSERT_EQ(histogram[9], 1);
+    ASSERT_EQ(histogram.back(), 1);
+    ASSERT_EQ(total_count(histogram), 4);
+
+    sink.reset();
+    ASSERT_EQ(sink.counter(cryp::metric_counter::encrypted_bytes), 0);
+    ASSERT_EQ(total_count(sink.phase_histogram(cryp::metric_phase::transform)), 0);
+}
+
+TEST(metrics_tests, test_symcrypt_metrics)
+{
+    cryp::histogram_metrics_sink sink;
+    ASSERT_EQ(cryp::current_metrics_sink(), nullptr);
+    cryp::set_metrics_sink(&sink);
+    ASSERT_EQ(cryp::current_metrics_sink(), &sink);
+
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    std::vector<uint8_t> data(100, 1);
+    symcrypt.encrypt(data, cryp::execution_policy::sequential());
+    symcrypt.decrypt(data, cryp::execution_policy::sequential());
+    cryp::set_metrics_sink(nullptr);
+
+    if constexpr (cryp::instrumentation_is_enabled)
+    {
+        ASSERT_EQ(sink.counter(cryp::metric_counter::encrypt_calls), 1);
+        ASSERT_EQ(sink.counter(cryp::metric_counter::decrypt_calls), 1);
+        ASSERT_EQ(sink.counter(cryp::metric_counter::encrypted_bytes), 100);
+        ASSERT_EQ(sink.counter(cryp::metric_counter::decrypted_bytes), 100);
+        ASSERT_EQ(sink.counter(cryp::metric_counter::random_bytes_calls), 1);
+        ASSERT_EQ(sink.counter(cryp::metric_counter::random_bytes), 8);
+        ASSERT_EQ(sink.counter(cryp::metric_counter::reallocations), 1);
+        ASSERT_EQ(sink.counter(cryp::metric_counter::sequential_dispatches), 2);
+        ASSERT_EQ(sink.counter(cryp::metric_counter::parallel_dispatches), 0);
+        ASSERT_EQ(total_count(sink.phase_histogram(cryp::metric_phase::random_bytes_generation)), 1);
+        ASSERT_EQ(total_count(sink.phase_histogram(cryp::metric_phase::keystream_construction)), 2);
+        ASSERT_EQ(total_count(sink.phase_histogram(cryp::metric_phase::transform)), 2);
+    }
+    else
+    {
+        for (std::size_t i = 0; i < cryp::metric_counter_count; ++i)
+            ASSERT_EQ(sink.counter(static_cast<cryp::metric_counter>(i)), 0);
+    }
+}
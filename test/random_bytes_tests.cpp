@@ -0,0 +1,43 @@
+#include <arba/cryp/random_bytes.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <vector>
+
+static_assert(cryp::random_bytes_generator<cryp::thread_local_random_bytes>);
+static_assert(cryp::random_bytes_generator<cryp::random_bytes_function>);
+
+TEST(random_bytes_tests, test_thread_local_random_bytes)
+{
+    cryp::thread_local_random_bytes generator;
+    std::vector<uint8_t> bytes(10000, 0);
+    generator(bytes);
+    std::array<std::size_t, 256> byte_counters{ 0 };
+    for (uint8_t byte : bytes)
+        ++(byte_counters[byte]);
+    ASSERT_EQ(std::ranges::count(byte_counters, 0), 0);
+}
+
+TEST(random_bytes_tests, test_thread_local_random_bytes_small_calls)
+{
+    cryp::thread_local_random_bytes generator;
+    std::vector<uint8_t> first_bytes(24, 0);
+    std::vector<uint8_t> second_bytes(24, 0);
+    generator(first_bytes);
+    generator(second_bytes);
+    ASSERT_NE(first_bytes, second_bytes);
+}
+
+TEST(random_bytes_tests, test_thread_local_random_bytes_threads)
+{
+    std::vector<uint8_t> first_bytes(64, 0);
+    std::vector<uint8_t> second_bytes(64, 0);
+    std::thread first_thread([&] { cryp::thread_local_random_bytes{}(first_bytes); });
+    std::thread second_thread([&] { cryp::thread_local_random_bytes{}(second_bytes); });
+    first_thread.join();
+    second_thread.join();
+    ASSERT_NE(first_bytes, second_bytes);
+}
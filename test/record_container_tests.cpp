@@ -0,0 +1,164 @@
+#include <arba/cryp/record_container.hpp>
+#include <arba/cryp/symcrypt.hpp>
+#include <arba/cryp/thread_pool.hpp>
+
+#include <arba/rand/urng.hpp>
+#include <gtest/gtest.h>
+
+#include "symcrypt_test_data.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+using symcrypt_test_data::key;
+
+std::vector<std::vector<std::byte>> make_records(std::size_t record_count)
+{
+    std::vector<std::vector<std::byte>> records(record_count);
+    rand::urng_u8<0, 255> rng(record_count);
+    for (std::size_t i = 0; i < record_count; ++i)
+    {
+        // Some records are empty, some are longer than a keystream period.
+        records[i].resize(i % 7 == 0 ? 0 : (i % 50 == 3 ? 5000 : rng() % 64));
+        std::ranges::generate(records[i], [&rng] { return static_cast<std::byte>(rng()); });
+    }
+    return records;
+}
+
+std::vector<std::byte> write_container(cryp::symcrypt& symcrypt, const std::vector<std::vector<std::byte>>& records,
+                                       std::size_t records_per_segment)
+{
+    std::vector<std::byte> container;
+    cryp::record_writer writer(symcrypt, cryp::make_vector_sink(container), records_per_segment);
+    for (std::size_t i = 0; i < records.size(); ++i)
+        EXPECT_EQ(writer.append(records[i]), i);
+    writer.finish();
+    return container;
+}
+} // namespace
+
+TEST(record_container_tests, test_write_read)
+{
+    cryp::symcrypt symcrypt(key);
+    for (std::size_t record_count : { 0, 1, 5, 6, 100 })
+    {
+        const std::vector<std::vector<std::byte>> records = make_records(record_count);
+        const std::vector<std::byte> container = write_container(symcrypt, records, 3);
+
+        const cryp::record_reader reader(symcrypt, container);
+        ASSERT_EQ(reader.record_count(), record_count);
+        ASSERT_EQ(reader.records_per_segment(), 3);
+        ASSERT_EQ(reader.segment_count(), (record_count + 2) / 3);
+        // Random access, backwards.
+        for (std::size_t i = record_count; i-- > 0;)
+        {
+            ASSERT_EQ(reader.record_size(i), records[i].size());
+            ASSERT_EQ(reader.record(i), records[i]);
+            std::vector<std::byte> output(records[i].size() + 1);
+            ASSERT_EQ(reader.read_record(i, output), records[i].size());
+            ASSERT_TRUE(std::ranges::equal(std::span(output).first(records[i].size()), records[i]));
+        }
+        ASSERT_THROW(reader.record(record_count), std::out_of_range);
+    }
+}
+
+TEST(record_container_tests, test_for_each_record)
+{
+    cryp::symcrypt symcrypt(key);
+    cryp::thread_pool pool(4);
+    symcrypt.set_parallel_executor(pool);
+    const std::vector<std::vector<std::byte>> records = make_records(1000);
+    const std::vector<std::byte> container = write_container(symcrypt, records, 16);
+
+    const cryp::record_reader reader(symcrypt, container);
+    for (const cryp::execution_policy& policy :
+         { cryp::execution_policy::sequential(), cryp::execution_policy::parallel() })
+    {
+        // Each record is visited once, by one task: no lock is needed.
+        std::vector<std::vector<std::byte>> visited_records(records.size());
+        std::vector<int> visit_counts(records.size(), 0);
+        reader.for_each_record(
+            [&](std::size_t record_index, std::span<const std::byte> record)
+            {
+                visited_records[record_index].assign(record.begin(), record.end());
+                ++visit_counts[record_index];
+            },
+            policy);
+        ASSERT_EQ(visited_records, records);
+        ASSERT_TRUE(std::ranges::all_of(visit_counts, [](int count) { return count == 1; }));
+    }
+}
+
+TEST(record_container_tests, test_container_size)
+{
+    cryp::symcrypt symcrypt(key);
+    const std::vector<std::vector<std::byte>> records = make_records(1000);
+    const std::vector<std::byte> container = write_container(symcrypt, records, 100);
+
+    std::size_t independent_size = 0;
+    for (const std::vector<std::byte>& record : records)
+        independent_size += cryp::symcrypt::encrypted_size(record.size());
+    ASSERT_LT(container.size(), independent_size);
+}
+
+TEST(record_container_tests, test_errors)
+{
+    cryp::symcrypt symcrypt(key);
+    std::vector<std::byte> container;
+    ASSERT_THROW(cryp::record_writer(symcrypt, cryp::make_vector_sink(container), 0), std::invalid_argument);
+
+    cryp::record_writer writer(symcrypt, cryp::make_vector_sink(container), 2);
+    const std::vector<std::byte> record(10, std::byte(7));
+    writer.append(record);
+    writer.append(record);
+    writer.append(record);
+    writer.finish();
+    ASSERT_TRUE(writer.is_finished());
+    ASSERT_THROW(writer.append(record), std::logic_error);
+    ASSERT_THROW(writer.finish(), std::logic_error);
+
+    // Not a container, or a truncated one.
+    ASSERT_THROW(cryp::record_reader(symcrypt, std::span(container).first(container.size() - 1)),
+                 std::invalid_argument);
+    ASSERT_THROW(cryp::record_reader(symcrypt, std::span(container).subspan(1)), std::invalid_argument);
+    const std::vector<std::byte> data(100);
+    ASSERT_THROW(cryp::record_reader(symcrypt, data), std::invalid_argument);
+    // A corrupted record count.
+    std::vector<std::byte> corrupted_container = container;
+    corrupted_container[corrupted_container.size() - cryp::record_container_format::magic.size() - 1] = std::byte(1);
+    ASSERT_THROW(cryp::record_reader(symcrypt, corrupted_container), std::invalid_argument);
+
+    const cryp::record_reader reader(symcrypt, container);
+    std::vector<std::byte> output(record.size() - 1);
+    ASSERT_THROW(reader.read_record(0, output), std::invalid_argument);
+    ASSERT_THROW(reader.record(3), std::out_of_range);
+}
+
+TEST(record_container_tests, test_corrupted_footer)
+{
+    cryp::symcrypt symcrypt(key);
+    const std::vector<std::vector<std::byte>> records = make_records(1);
+    const std::vector<std::byte> container = write_container(symcrypt, records, 4);
+    const std::size_t footer_offset = container.size() - cryp::record_container_format::footer_size;
+
+    // Footers whose segments cannot hold the index of their records.
+    const auto patch_footer = [&](uint64_t records_per_segment, uint64_t record_count)
+    {
+        std::vector<std::byte> corrupted_container = container;
+        for (std::size_t i = 0; i < sizeof(uint64_t); ++i)
+        {
+            corrupted_container[footer_offset + i] = static_cast<std::byte>(records_per_segment >> (8 * i));
+            corrupted_container[footer_offset + sizeof(uint64_t) + i] = static_cast<std::byte>(record_count >> (8 * i));
+        }
+        return corrupted_container;
+    };
+    for (uint64_t count : { uint64_t(1) << 62, uint64_t(1) << 40, uint64_t(100) })
+        ASSERT_THROW(cryp::record_reader(symcrypt, patch_footer(count, count)), std::invalid_argument);
+    // More segments than segment ends.
+    ASSERT_THROW(cryp::record_reader(symcrypt, patch_footer(1, 2)), std::invalid_argument);
+    ASSERT_NO_THROW(cryp::record_reader(symcrypt, patch_footer(1, 1)));
+}
@@ -0,0 +1,78 @@
+#include <arba/cryp/static_symcrypt.hpp>
+#include <arba/cryp/symcrypt.hpp>
+
+#include <arba/rand/urng.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+constexpr cryp::symcrypt_base::crypto_key key{ 0xa8, 0x69, 0xad, 0x09, 0x1e, 0x02, 0x45, 0x2b,
+                                               0x81, 0xc8, 0x2e, 0xfc, 0x5d, 0xfa, 0x24, 0xad };
+
+// Any key hash is fine to check the compile-time encryption.
+constexpr cryp::static_symcrypt<5> constexpr_symcrypt(key, { 1, 2, 3, 4, 5, 6, 7, 8 });
+constexpr cryp::static_symcrypt<5>::data_array constexpr_data{ 'h', 'e', 'l', 'l', 'o' };
+constexpr cryp::static_symcrypt<5>::random_bytes_array constexpr_random_bytes{
+    9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 10, 20, 30, 40, 50, 60, 70, 80, 90
+};
+constexpr auto constexpr_encrypted_data = constexpr_symcrypt.encrypt(constexpr_data, constexpr_random_bytes);
+static_assert(constexpr_encrypted_data.size() == cryp::symcrypt_base::min_encrypted_size);
+static_assert(constexpr_symcrypt.decrypt(constexpr_encrypted_data) == constexpr_data);
+
+template <std::size_t DataSize>
+void test_same_as_symcrypt()
+{
+    using static_symcrypt_type = cryp::static_symcrypt<DataSize>;
+    static_symcrypt_type static_symcrypt(key);
+    typename static_symcrypt_type::data_array data;
+    std::ranges::generate(data, rand::urng_u8<0, 255>(DataSize));
+
+    // symcrypt draws the random bytes in the same order: the padding, then the offsets.
+    typename static_symcrypt_type::random_bytes_array random_bytes;
+    std::ranges::generate(random_bytes, rand::urng_u8<0, 255>(42));
+    typename static_symcrypt_type::encrypted_array encrypted_data = static_symcrypt.encrypt(data, random_bytes);
+
+    std::vector<uint8_t> expected_data(data.begin(), data.end());
+    cryp::symcrypt symcrypt(key, [&](std::span<uint8_t> bytes) { std::ranges::copy(random_bytes, bytes.begin()); });
+    symcrypt.encrypt(expected_data);
+    ASSERT_TRUE(std::ranges::equal(encrypted_data, expected_data));
+
+    ASSERT_EQ(static_symcrypt.decrypt(encrypted_data), data);
+    encrypted_data = static_symcrypt.encrypt(data);
+    std::vector<uint8_t> decrypted_data(encrypted_data.begin(), encrypted_data.end());
+    symcrypt.decrypt(decrypted_data);
+    ASSERT_TRUE(std::ranges::equal(decrypted_data, data));
+}
+} // namespace
+
+TEST(static_symcrypt_tests, test_layout)
+{
+    ASSERT_EQ(cryp::static_symcrypt<0>::padding_size, 16);
+    ASSERT_EQ(cryp::static_symcrypt<0>::random_bytes_size, 24);
+    ASSERT_EQ(cryp::static_symcrypt<0>::encrypted_size, 25);
+    ASSERT_EQ(cryp::static_symcrypt<20>::padding_size, 0);
+    ASSERT_EQ(cryp::static_symcrypt<20>::random_bytes_size, 8);
+    ASSERT_EQ(cryp::static_symcrypt<20>::encrypted_size, 29);
+}
+
+TEST(static_symcrypt_tests, test_same_as_symcrypt)
+{
+    test_same_as_symcrypt<0>();
+    test_same_as_symcrypt<5>();
+    test_same_as_symcrypt<16>();
+    test_same_as_symcrypt<17>();
+    test_same_as_symcrypt<63>();
+    test_same_as_symcrypt<64>();
+    test_same_as_symcrypt<1000>();
+    test_same_as_symcrypt<5000>();
+}
+
+TEST(static_symcrypt_tests, test_key_hash_bytes)
+{
+    cryp::static_symcrypt<8> static_symcrypt(key);
+    ASSERT_EQ(static_symcrypt.key(), key);
+    ASSERT_EQ(static_symcrypt.key_hash_bytes(), cryp::key_schedule(key).key_hash_bytes());
+}
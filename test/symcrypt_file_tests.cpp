@@ -0,0 +1,238 @@
+#include <arba/cryp/symcrypt.hpp>
+#include <arba/cryp/symcrypt_file.hpp>
+#include <arba/cryp/thread_pool.hpp>
+
+#include <arba/rand/urng.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+const std::filesystem::path test_dir = std::filesystem::temp_directory_path() / "arba-cryp-symcrypt_file_tests";
+
+void write_file(const std::filesystem::path& path, const std::vector<uint8_t>& bytes)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+std::vector<uint8_t> read_file(const std::filesystem::path& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+// Executor counting the tasks dispatched to a thread pool.
+class counting_executor : public cryp::executor
+{
+public:
+    explicit counting_executor(cryp::executor& exec) : exec_(exec) {}
+
+    std::size_t concurrency() const override { return exec_.concurrency(); }
+    void bulk_execute(std::size_t task_count, const std::function<void(std::size_t)>& task) override
+    {
+        task_count_ += task_count;
+        exec_.bulk_execute(task_count, task);
+    }
+
+    inline std::size_t task_count() const { return task_count_; }
+
+private:
+    std::atomic_size_t task_count_ = 0;
+    cryp::executor& exec_;
+};
+
+class symcrypt_file_tests : public ::testing::Test
+{
+protected:
+    void SetUp() override { std::filesystem::create_directories(test_dir); }
+    void TearDown() override { std::filesystem::remove_all(test_dir); }
+};
+} // namespace
+
+TEST_F(symcrypt_file_tests, test_encrypt_decrypt_file)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    const std::filesystem::path data_path = test_dir / "data";
+    const std::filesystem::path encrypted_path = test_dir / "data.cryp";
+    const std::filesystem::path decrypted_path = test_dir / "data.decrypted";
+    for (std::size_t data_size : { 0, 5, 16, 17, 100000 })
+    {
+        std::vector<uint8_t> data(data_size);
+        std::ranges::generate(data, rand::urng_u8<0, 255>(data_size));
+        write_file(data_path, data);
+
+        ASSERT_EQ(cryp::encrypt_file(symcrypt, data_path, encrypted_path), cryp::symcrypt::encrypted_size(data_size));
+        std::vector<uint8_t> encrypted_data = read_file(encrypted_path);
+        ASSERT_EQ(encrypted_data.size(), cryp::symcrypt::encrypted_size(data_size));
+        symcrypt.decrypt(encrypted_data);
+        ASSERT_EQ(encrypted_data, data);
+
+        ASSERT_EQ(cryp::decrypt_file(symcrypt, encrypted_path, decrypted_path), data_size);
+        ASSERT_EQ(read_file(decrypted_path), data);
+    }
+}
+
+TEST_F(symcrypt_file_tests, test_errors)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    const std::filesystem::path data_path = test_dir / "data";
+    const std::filesystem::path output_path = test_dir / "output";
+    ASSERT_THROW(cryp::encrypt_file(symcrypt, test_dir / "missing", output_path), std::filesystem::filesystem_error);
+    ASSERT_FALSE(std::filesystem::exists(output_path));
+
+    write_file(data_path, std::vector<uint8_t>(10, 1));
+    ASSERT_THROW(cryp::encrypt_file(symcrypt, data_path, data_path), std::invalid_argument);
+    ASSERT_EQ(read_file(data_path), std::vector<uint8_t>(10, 1));
+
+    write_file(output_path, std::vector<uint8_t>(3, 2));
+    ASSERT_THROW(cryp::decrypt_file(symcrypt, data_path, output_path), std::invalid_argument);
+    ASSERT_EQ(read_file(output_path), std::vector<uint8_t>(3, 2));
+}
+
+TEST_F(symcrypt_file_tests, test_encrypt_decrypt_file_async)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    const std::filesystem::path data_path = test_dir / "data";
+    const std::filesystem::path encrypted_path = test_dir / "data.cryp";
+    const std::filesystem::path decrypted_path = test_dir / "data.decrypted";
+    ASSERT_TRUE(cryp::file_io_backend_is_available(cryp::file_io_backend::threads));
+    for (cryp::file_io_backend backend :
+         { cryp::file_io_backend::automatic, cryp::file_io_backend::io_uring, cryp::file_io_backend::threads })
+    {
+        if (!cryp::file_io_backend_is_available(backend))
+            continue;
+        // Small chunks and few buffers, so that the buffers are reused.
+        const cryp::async_file_options options{ .chunk_size = 4096, .buffer_count = 3, .backend = backend };
+        for (std::size_t data_size : { 0, 5, 16, 17, 100000 })
+        {
+            std::vector<uint8_t> data(data_size);
+            std::ranges::generate(data, rand::urng_u8<0, 255>(data_size));
+            write_file(data_path, data);
+
+            ASSERT_EQ(cryp::encrypt_file_async(symcrypt, data_path, encrypted_path, options,
+                                               cryp::execution_policy::parallel()),
+                      cryp::symcrypt::encrypted_size(data_size));
+            ASSERT_EQ(cryp::decrypt_file(symcrypt, encrypted_path, decrypted_path), data_size);
+            ASSERT_EQ(read_file(decrypted_path), data);
+
+            cryp::encrypt_file(symcrypt, data_path, encrypted_path);
+            ASSERT_EQ(cryp::decrypt_file_async(symcrypt, encrypted_path, decrypted_path, options,
+                                               cryp::execution_policy::parallel()),
+                      data_size);
+            ASSERT_EQ(read_file(decrypted_path), data);
+        }
+    }
+
+    const std::filesystem::path output_path = test_dir / "output";
+    ASSERT_THROW(cryp::encrypt_file_async(symcrypt, data_path, output_path, { .chunk_size = 0 }),
+                 std::invalid_argument);
+    ASSERT_THROW(cryp::encrypt_file_async(symcrypt, test_dir / "missing", output_path),
+                 std::filesystem::filesystem_error);
+    ASSERT_FALSE(std::filesystem::exists(output_path));
+    write_file(data_path, std::vector<uint8_t>(10, 1));
+    write_file(output_path, std::vector<uint8_t>(3, 2));
+    ASSERT_THROW(cryp::decrypt_file_async(symcrypt, data_path, output_path), std::invalid_argument);
+    ASSERT_EQ(read_file(output_path), std::vector<uint8_t>(3, 2));
+}
+
+TEST_F(symcrypt_file_tests, test_bulk_file_job)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    cryp::thread_pool pool(4);
+    symcrypt.set_parallel_executor(pool);
+
+    // A tree of files of various sizes, one of them large enough to be split into chunks.
+    const std::filesystem::path data_dir = test_dir / "data";
+    std::vector<std::filesystem::path> relative_paths;
+    for (std::size_t i = 0; i < 40; ++i)
+    {
+        const std::filesystem::path relative_path =
+            std::filesystem::path("dir_" + std::to_string(i % 3)) / ("file_" + std::to_string(i));
+        std::filesystem::create_directories((data_dir / relative_path).parent_path());
+        const std::size_t data_size = i == 0 ? 3 * 1024 * 1024 : i * i * 37;
+        std::vector<uint8_t> data(data_size);
+        std::ranges::generate(data, rand::urng_u8<0, 255>(data_size));
+        write_file(data_dir / relative_path, data);
+        relative_paths.push_back(relative_path);
+    }
+
+    const std::filesystem::path encrypted_dir = test_dir / "encrypted";
+    cryp::bulk_file_job encryption_job(symcrypt);
+    encryption_job.add_directory(data_dir, encrypted_dir);
+    ASSERT_EQ(encryption_job.file_count(), relative_paths.size());
+    std::vector<cryp::bulk_file_job::progress> progresses;
+    encryption_job.set_progress_function([&](const cryp::bulk_file_job::progress& progress)
+                                         { progresses.push_back(progress); });
+    const std::size_t encrypted_size = encryption_job.encrypt(cryp::execution_policy::parallel());
+    ASSERT_EQ(progresses.size(), relative_paths.size());
+    ASSERT_EQ(progresses.back().done_file_count, relative_paths.size());
+    ASSERT_EQ(progresses.back().done_byte_count, progresses.back().byte_count);
+
+    std::size_t expected_encrypted_size = 0;
+    for (const std::filesystem::path& relative_path : relative_paths)
+    {
+        std::vector<uint8_t> encrypted_data = read_file(encrypted_dir / relative_path);
+        expected_encrypted_size += encrypted_data.size();
+        symcrypt.decrypt(encrypted_data);
+        ASSERT_EQ(encrypted_data, read_file(data_dir / relative_path));
+    }
+    ASSERT_EQ(encrypted_size, expected_encrypted_size);
+
+    const std::filesystem::path decrypted_dir = test_dir / "decrypted";
+    cryp::bulk_file_job decryption_job(symcrypt);
+    decryption_job.add_directory(encrypted_dir, decrypted_dir);
+    ASSERT_EQ(decryption_job.decrypt(), progresses.back().byte_count);
+    for (const std::filesystem::path& relative_path : relative_paths)
+        ASSERT_EQ(read_file(decrypted_dir / relative_path), read_file(data_dir / relative_path));
+
+    // The other files are processed when one fails.
+    cryp::bulk_file_job failing_job(symcrypt);
+    failing_job.add_file(test_dir / "missing", test_dir / "missing.cryp");
+    failing_job.add_file(data_dir / relative_paths[1], test_dir / "file_1.cryp");
+    ASSERT_THROW(failing_job.encrypt(), std::filesystem::filesystem_error);
+    ASSERT_FALSE(std::filesystem::exists(test_dir / "missing.cryp"));
+    ASSERT_TRUE(std::filesystem::exists(test_dir / "file_1.cryp"));
+}
+
+TEST_F(symcrypt_file_tests, test_bulk_file_job_small_files)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    cryp::thread_pool pool(4);
+    counting_executor executor(pool);
+    symcrypt.set_parallel_executor(executor);
+
+    // Far less than the parallel threshold of the automatic policy, in total.
+    const std::filesystem::path data_dir = test_dir / "data";
+    std::filesystem::create_directories(data_dir);
+    for (std::size_t i = 0; i < 300; ++i)
+        write_file(data_dir / ("file_" + std::to_string(i)), std::vector<uint8_t>(i % 100, static_cast<uint8_t>(i)));
+
+    cryp::bulk_file_job encryption_job(symcrypt);
+    encryption_job.add_directory(data_dir, test_dir / "encrypted");
+    encryption_job.encrypt(cryp::execution_policy::automatic());
+    ASSERT_GT(executor.task_count(), 1);
+
+    cryp::bulk_file_job decryption_job(symcrypt);
+    decryption_job.add_directory(test_dir / "encrypted", test_dir / "decrypted");
+    decryption_job.decrypt(cryp::execution_policy::automatic());
+    for (std::size_t i = 0; i < 300; ++i)
+        ASSERT_EQ(read_file(test_dir / "decrypted" / ("file_" + std::to_string(i))),
+                  read_file(data_dir / ("file_" + std::to_string(i))));
+
+    // A sequential policy dispatches no task.
+    const std::size_t task_count = executor.task_count();
+    cryp::bulk_file_job sequential_job(symcrypt);
+    sequential_job.add_directory(data_dir, test_dir / "sequential");
+    sequential_job.encrypt(cryp::execution_policy::sequential());
+    ASSERT_EQ(executor.task_count(), task_count);
+}
@@ -0,0 +1,139 @@
+#include <arba/cryp/symcrypt.hpp>
+#include <arba/cryp/symcrypt_pipeline.hpp>
+#include <arba/cryp/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include "symcrypt_test_data.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+using symcrypt_test_data::key;
+using symcrypt_test_data::make_data;
+} // namespace
+
+TEST(symcrypt_pipeline_tests, test_encrypt_decrypt_memory)
+{
+    cryp::symcrypt symcrypt(key);
+    cryp::thread_pool pool(4);
+    symcrypt.set_parallel_executor(pool);
+    for (std::size_t data_size : { 0, 1, 16, 17, 18, 2305, 100000 })
+    {
+        std::vector<std::byte> data = make_data(data_size);
+        for (std::size_t chunk_size : { 1, 17, 1000, 65536 })
+        {
+            const cryp::pipeline_options options{ .chunk_size = chunk_size, .buffer_count = 3 };
+            for (const cryp::execution_policy& policy :
+                 { cryp::execution_policy::sequential(), cryp::execution_policy::parallel() })
+            {
+                std::vector<std::byte> stream;
+                ASSERT_EQ(cryp::encrypt_pipeline(symcrypt, cryp::make_memory_source(data),
+                                                 cryp::make_vector_sink(stream), options, policy),
+                          cryp::symcrypt_stream_format::encrypted_size(data_size));
+                ASSERT_EQ(stream.size(), cryp::symcrypt_stream_format::encrypted_size(data_size));
+
+                // The stream format is the one of symcrypt_decoder.
+                cryp::symcrypt_decoder decoder(symcrypt);
+                std::vector<std::byte> decoded_data(stream.size());
+                std::size_t decoded_size = decoder.update(stream, decoded_data);
+                decoded_size += decoder.finish(std::span(decoded_data).subspan(decoded_size));
+                decoded_data.resize(decoded_size);
+                ASSERT_EQ(decoded_data, data);
+
+                std::vector<std::byte> decrypted_data;
+                ASSERT_EQ(cryp::decrypt_pipeline(symcrypt, cryp::make_memory_source(stream),
+                                                 cryp::make_vector_sink(decrypted_data), options, policy),
+                          data_size);
+                ASSERT_EQ(decrypted_data, data);
+            }
+        }
+    }
+}
+
+TEST(symcrypt_pipeline_tests, test_encrypt_decrypt_stream)
+{
+    cryp::symcrypt symcrypt(key);
+    std::vector<std::byte> data = make_data(300000);
+    std::istringstream input(std::string(reinterpret_cast<const char*>(data.data()), data.size()));
+    std::ostringstream encrypted_output;
+    const cryp::pipeline_options options{ .chunk_size = 4096 };
+    cryp::encrypt_pipeline(symcrypt, cryp::make_stream_source(input), cryp::make_stream_sink(encrypted_output),
+                           options);
+
+    std::istringstream encrypted_input(encrypted_output.str());
+    std::ostringstream output;
+    ASSERT_EQ(cryp::decrypt_pipeline(symcrypt, cryp::make_stream_source(encrypted_input),
+                                     cryp::make_stream_sink(output), options),
+              data.size());
+    const std::string decrypted_data = output.str();
+    ASSERT_TRUE(std::ranges::equal(std::as_bytes(std::span(decrypted_data)), data));
+}
+
+TEST(symcrypt_pipeline_tests, test_bounded_memory)
+{
+    // The source never gets ahead of the sink by more than buffer_count chunks.
+    cryp::symcrypt symcrypt(key);
+    const cryp::pipeline_options options{ .chunk_size = 100, .buffer_count = 4 };
+    std::size_t read_chunk_count = 0;
+    std::size_t written_chunk_count = 0;
+    std::size_t max_chunks_in_flight = 0;
+    std::mutex mutex;
+    const cryp::chunk_source source = [&](std::span<std::byte> buffer)
+    {
+        std::lock_guard lock(mutex);
+        if (read_chunk_count == 1000)
+            return std::size_t(0);
+        ++read_chunk_count;
+        max_chunks_in_flight = std::max(max_chunks_in_flight, read_chunk_count - written_chunk_count);
+        std::ranges::fill(buffer, std::byte(7));
+        return buffer.size();
+    };
+    std::size_t data_size = 0;
+    const cryp::chunk_sink sink = [&](std::span<const std::byte> bytes)
+    {
+        std::lock_guard lock(mutex);
+        // Without the header and the trailer.
+        if (bytes.size() == options.chunk_size)
+            ++written_chunk_count;
+        data_size += bytes.size();
+    };
+    cryp::encrypt_pipeline(symcrypt, source, sink, options);
+    ASSERT_EQ(written_chunk_count, 1000);
+    ASSERT_EQ(data_size, cryp::symcrypt_stream_format::encrypted_size(100000));
+    ASSERT_LE(max_chunks_in_flight, options.buffer_count);
+}
+
+TEST(symcrypt_pipeline_tests, test_errors)
+{
+    cryp::symcrypt symcrypt(key);
+    std::vector<std::byte> data = make_data(10000);
+    const cryp::pipeline_options options{ .chunk_size = 100 };
+    const cryp::chunk_source failing_source = [](std::span<std::byte>) -> std::size_t
+    { throw std::runtime_error("source error"); };
+    std::vector<std::byte> stream;
+    ASSERT_THROW(cryp::encrypt_pipeline(symcrypt, failing_source, cryp::make_vector_sink(stream), options),
+                 std::runtime_error);
+    const cryp::chunk_sink failing_sink = [](std::span<const std::byte>) { throw std::runtime_error("sink error"); };
+    ASSERT_THROW(cryp::encrypt_pipeline(symcrypt, cryp::make_memory_source(data), failing_sink, options),
+                 std::runtime_error);
+    ASSERT_THROW(cryp::encrypt_pipeline(symcrypt, cryp::make_memory_source(data), cryp::make_vector_sink(stream),
+                                        cryp::pipeline_options{ .chunk_size = 0 }),
+                 std::invalid_argument);
+
+    stream.clear();
+    cryp::encrypt_pipeline(symcrypt, cryp::make_memory_source(data), cryp::make_vector_sink(stream), options);
+    std::vector<std::byte> decrypted_data;
+    for (std::size_t truncated_size : { 0, 5, 8, 24 })
+    {
+        ASSERT_THROW(cryp::decrypt_pipeline(symcrypt, cryp::make_memory_source(std::span(stream).first(truncated_size)),
+                                            cryp::make_vector_sink(decrypted_data), options),
+                     std::invalid_argument);
+    }
+}
@@ -0,0 +1,103 @@
+#include <arba/cryp/symcrypt.hpp>
+#include <arba/cryp/symcrypt_range.hpp>
+
+#include <gtest/gtest.h>
+
+#include "symcrypt_test_data.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+using symcrypt_test_data::make_data;
+} // namespace
+
+TEST(symcrypt_range_tests, test_encrypt_range)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    for (std::size_t data_size : { 0, 3, 16, 17, 10000 })
+    {
+        const std::vector<uint8_t> data = make_data<uint8_t>(data_size);
+        cryp::symcrypt_range_encryptor encryptor(symcrypt, data_size);
+        ASSERT_EQ(encryptor.data_size(), data_size);
+        ASSERT_EQ(encryptor.encrypted_size(), cryp::symcrypt::encrypted_size(data_size));
+
+        // The ranges are encrypted from the last one to the first one.
+        std::vector<uint8_t> ciphertext(encryptor.encrypted_size());
+        std::span<std::byte> encrypted_bytes = std::as_writable_bytes(std::span(ciphertext));
+        const std::size_t middle = data_size / 3;
+        encryptor.encrypt_range(middle, std::as_bytes(std::span(data).subspan(middle)),
+                                encrypted_bytes.subspan(middle));
+        encryptor.encrypt_range(0, std::as_bytes(std::span(data).first(middle)), encrypted_bytes);
+        std::ranges::copy(encryptor.trailer(), encrypted_bytes.begin() + data_size);
+
+        symcrypt.decrypt(ciphertext);
+        ASSERT_EQ(ciphertext, data);
+    }
+}
+
+TEST(symcrypt_range_tests, test_decrypt_range)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    for (std::size_t data_size : { 0, 3, 16, 17, 10000 })
+    {
+        const std::vector<uint8_t> data = make_data<uint8_t>(data_size);
+        std::vector<uint8_t> ciphertext = data;
+        symcrypt.encrypt(ciphertext);
+        std::span<const std::byte> encrypted_bytes = std::as_bytes(std::span(ciphertext));
+
+        cryp::symcrypt_range_decryptor decryptor(symcrypt, encrypted_bytes.last<cryp::symcrypt::trailer_size>(),
+                                                 ciphertext.size());
+        ASSERT_EQ(decryptor.data_size(), data_size);
+        for (std::size_t offset : { std::size_t(0), data_size / 3, data_size })
+        {
+            const std::size_t size = (data_size - offset) / 2;
+            std::vector<std::byte> range(size);
+            decryptor.decrypt_range(offset, encrypted_bytes.subspan(offset, size), range);
+            ASSERT_TRUE(std::ranges::equal(range, std::as_bytes(std::span(data).subspan(offset, size))));
+        }
+    }
+}
+
+TEST(symcrypt_range_tests, test_reader)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    const std::vector<uint8_t> data = make_data<uint8_t>(5000);
+    std::vector<uint8_t> ciphertext = data;
+    symcrypt.encrypt(ciphertext);
+
+    std::size_t read_size = 0;
+    auto read_at = [&](std::size_t offset, std::span<std::byte> bytes)
+    {
+        read_size += bytes.size();
+        std::ranges::copy(std::as_bytes(std::span(ciphertext)).subspan(offset, bytes.size()), bytes.begin());
+    };
+    cryp::symcrypt_range_reader reader(symcrypt, ciphertext.size(), read_at);
+    ASSERT_EQ(read_size, cryp::symcrypt::trailer_size);
+    ASSERT_EQ(reader.data_size(), data.size());
+
+    std::vector<std::byte> range(100);
+    reader.read(2300, range);
+    ASSERT_EQ(read_size, cryp::symcrypt::trailer_size + range.size());
+    ASSERT_TRUE(std::ranges::equal(range, std::as_bytes(std::span(data).subspan(2300, 100))));
+}
+
+TEST(symcrypt_range_tests, test_errors)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    std::vector<uint8_t> ciphertext = make_data<uint8_t>(100);
+    symcrypt.encrypt(ciphertext);
+    std::span<const std::byte> encrypted_bytes = std::as_bytes(std::span(ciphertext));
+    ASSERT_THROW(cryp::symcrypt_range_decryptor(symcrypt, encrypted_bytes.last<cryp::symcrypt::trailer_size>(), 10),
+                 std::invalid_argument);
+
+    cryp::symcrypt_range_decryptor decryptor(symcrypt, encrypted_bytes.last<cryp::symcrypt::trailer_size>(),
+                                             ciphertext.size());
+    std::vector<std::byte> range(10);
+    ASSERT_THROW(decryptor.decrypt_range(95, range), std::out_of_range);
+    ASSERT_THROW(decryptor.decrypt_range(101, std::span<std::byte>()), std::out_of_range);
+    ASSERT_THROW(decryptor.decrypt_range(0, encrypted_bytes.first(10), std::span(range).first(5)),
+                 std::invalid_argument);
+}
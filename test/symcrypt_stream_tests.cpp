@@ -0,0 +1,168 @@
+#include <arba/cryp/symcrypt.hpp>
+#include <arba/cryp/symcrypt_stream.hpp>
+
+#include <gtest/gtest.h>
+
+#include "symcrypt_test_data.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+using symcrypt_test_data::key;
+using symcrypt_test_data::make_data;
+
+std::vector<std::byte> encode(cryp::symcrypt_encoder& encoder, const std::vector<std::byte>& data,
+                              std::size_t chunk_size)
+{
+    std::vector<std::byte> stream;
+    std::vector<std::byte> output(cryp::symcrypt_encoder::max_update_size(chunk_size));
+    for (std::size_t i = 0; i < data.size(); i += chunk_size)
+    {
+        std::span<const std::byte> chunk = std::span(data).subspan(i, std::min(chunk_size, data.size() - i));
+        std::size_t output_size = encoder.update(chunk, output);
+        stream.insert(stream.end(), output.begin(), output.begin() + output_size);
+    }
+    std::vector<std::byte> trailer(cryp::symcrypt_encoder::max_finish_size());
+    std::size_t trailer_size = encoder.finish(trailer);
+    stream.insert(stream.end(), trailer.begin(), trailer.begin() + trailer_size);
+    return stream;
+}
+
+std::vector<std::byte> decode(cryp::symcrypt_decoder& decoder, const std::vector<std::byte>& stream,
+                              std::size_t chunk_size)
+{
+    std::vector<std::byte> data;
+    std::vector<std::byte> output(cryp::symcrypt_decoder::max_update_size(chunk_size));
+    for (std::size_t i = 0; i < stream.size(); i += chunk_size)
+    {
+        std::span<const std::byte> chunk = std::span(stream).subspan(i, std::min(chunk_size, stream.size() - i));
+        std::size_t output_size = decoder.update(chunk, output);
+        data.insert(data.end(), output.begin(), output.begin() + output_size);
+    }
+    std::vector<std::byte> trailer(cryp::symcrypt_decoder::max_finish_size());
+    std::size_t trailer_size = decoder.finish(trailer);
+    data.insert(data.end(), trailer.begin(), trailer.begin() + trailer_size);
+    return data;
+}
+} // namespace
+
+TEST(symcrypt_stream_tests, test_encode_decode)
+{
+    cryp::symcrypt symcrypt(key);
+    for (std::size_t data_size : { 0, 1, 15, 16, 17, 18, 100, 2304, 2305, 10000 })
+    {
+        std::vector<std::byte> data = make_data(data_size);
+        for (std::size_t chunk_size : { 1, 3, 8, 17, 1000, 4096 })
+        {
+            cryp::symcrypt_encoder encoder(symcrypt);
+            std::vector<std::byte> stream = encode(encoder, data, chunk_size);
+            ASSERT_TRUE(encoder.is_finished());
+            ASSERT_EQ(encoder.data_size(), data_size);
+            ASSERT_EQ(stream.size(), cryp::symcrypt_encoder::encrypted_size(data_size));
+
+            cryp::symcrypt_decoder decoder(symcrypt);
+            ASSERT_EQ(decode(decoder, stream, chunk_size), data);
+            ASSERT_TRUE(decoder.is_finished());
+            ASSERT_EQ(decoder.data_size(), data_size);
+        }
+    }
+}
+
+TEST(symcrypt_stream_tests, test_block_format)
+{
+    // The stream format is the block format where the offsets are moved up front.
+    cryp::symcrypt symcrypt(key);
+    for (std::size_t data_size : { 0, 16, 17, 5000 })
+    {
+        std::vector<std::byte> data = make_data(data_size);
+        cryp::symcrypt_encoder encoder(symcrypt);
+        std::vector<std::byte> stream = encode(encoder, data, 100);
+
+        std::vector<uint8_t> bytes(stream.size());
+        std::ranges::transform(stream, bytes.begin(), [](std::byte b) { return static_cast<uint8_t>(b); });
+        std::ranges::rotate(bytes, bytes.begin() + cryp::symcrypt_encoder::header_size);
+        symcrypt.decrypt(bytes);
+        ASSERT_TRUE(std::ranges::equal(std::as_bytes(std::span(bytes)), data));
+
+        std::vector<uint8_t> block(data_size);
+        std::ranges::transform(data, block.begin(), [](std::byte b) { return static_cast<uint8_t>(b); });
+        symcrypt.encrypt(block);
+        std::ranges::rotate(block, block.end() - cryp::symcrypt_decoder::header_size);
+        cryp::symcrypt_decoder decoder(symcrypt);
+        ASSERT_EQ(decode(decoder, std::vector<std::byte>(std::as_bytes(std::span(block)).begin(),
+                                                         std::as_bytes(std::span(block)).end()),
+                         7),
+                  data);
+    }
+}
+
+TEST(symcrypt_stream_tests, test_key_change)
+{
+    cryp::symcrypt symcrypt(key);
+    std::vector<std::byte> data = make_data(100);
+    cryp::symcrypt_encoder encoder(symcrypt);
+    symcrypt.set_key(std::string_view("other key"));
+    std::vector<std::byte> stream = encode(encoder, data, 10);
+
+    symcrypt.set_key(key);
+    cryp::symcrypt_decoder decoder(symcrypt);
+    ASSERT_EQ(decode(decoder, stream, 10), data);
+}
+
+TEST(symcrypt_stream_tests, test_errors)
+{
+    cryp::symcrypt symcrypt(key);
+    std::vector<std::byte> data = make_data(100);
+    cryp::symcrypt_encoder encoder(symcrypt);
+    std::vector<std::byte> output(data.size());
+    ASSERT_THROW(encoder.update(data, output), std::invalid_argument);
+    std::vector<std::byte> stream = encode(encoder, data, 10);
+    ASSERT_THROW(encoder.update(data, output), std::logic_error);
+    ASSERT_THROW(encoder.finish(output), std::logic_error);
+
+    std::vector<std::byte> truncated_stream(stream.begin(), stream.begin() + cryp::symcrypt_decoder::header_size + 16);
+    cryp::symcrypt_decoder decoder(symcrypt);
+    ASSERT_EQ(decoder.update(truncated_stream, output), 0);
+    ASSERT_THROW(decoder.finish(output), std::invalid_argument);
+
+    cryp::symcrypt_decoder other_decoder(symcrypt);
+    std::vector<std::byte> small_output(10);
+    ASSERT_THROW(other_decoder.update(stream, small_output), std::invalid_argument);
+    ASSERT_EQ(decode(other_decoder, stream, 10), data);
+}
+
+TEST(symcrypt_stream_tests, test_encode_decode_at)
+{
+    cryp::symcrypt symcrypt(key);
+    std::vector<std::byte> data = make_data(5000);
+    cryp::symcrypt_encoder encoder(symcrypt);
+    std::vector<std::byte> stream(cryp::symcrypt_encoder::encrypted_size(data.size()));
+    ASSERT_EQ(encoder.write_header(stream), cryp::symcrypt_encoder::header_size);
+    ASSERT_EQ(encoder.write_header(stream), 0);
+    // The chunks are encrypted out of order.
+    std::span<std::byte> body = std::span(stream).subspan(cryp::symcrypt_encoder::header_size);
+    encoder.encrypt_at(3000, std::span(data).subspan(3000), body.subspan(3000, 2000));
+    encoder.encrypt_at(0, std::span(data).first(3000), body.first(3000));
+    encoder.advance(data.size());
+    ASSERT_EQ(encoder.finish(body.subspan(data.size())), 1);
+
+    cryp::symcrypt_decoder decoder(symcrypt);
+    ASSERT_EQ(decode(decoder, stream, 100), data);
+
+    cryp::symcrypt_decoder other_decoder(symcrypt);
+    ASSERT_THROW(other_decoder.decrypt_at(0, body, body), std::logic_error);
+    ASSERT_EQ(other_decoder.read_header(std::span(stream).first(3)), 3);
+    ASSERT_FALSE(other_decoder.header_is_read());
+    ASSERT_EQ(other_decoder.read_header(std::span(stream).subspan(3)), cryp::symcrypt_decoder::header_size - 3);
+    ASSERT_TRUE(other_decoder.header_is_read());
+    std::vector<std::byte> decrypted_body(body.size());
+    other_decoder.decrypt_at(1000, body.subspan(1000), std::span(decrypted_body).subspan(1000));
+    other_decoder.decrypt_at(0, body.first(1000), decrypted_body);
+    const std::size_t data_size = cryp::symcrypt_decoder::decrypted_data_size(
+        decrypted_body.size(), static_cast<uint8_t>(decrypted_body.back()));
+    ASSERT_EQ(data_size, data.size());
+    ASSERT_TRUE(std::ranges::equal(std::span(decrypted_body).first(data_size), data));
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <arba/cryp/symcrypt_base.hpp>
+
+#include <arba/rand/urng.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Key and data shared by the tests of the symcrypt algorithms.
+namespace symcrypt_test_data
+{
+inline const cryp::symcrypt_base::crypto_key key{ 0xa8, 0x69, 0xad, 0x09, 0x1e, 0x02, 0x45, 0x2b,
+                                                  0x81, 0xc8, 0x2e, 0xfc, 0x5d, 0xfa, 0x24, 0xad };
+
+// Random data, always the same for a given size.
+template <class Byte = std::byte>
+std::vector<Byte> make_data(std::size_t size)
+{
+    std::vector<Byte> data(size);
+    rand::urng_u8<0, 255> rng(size);
+    std::ranges::generate(data, [&rng] { return static_cast<Byte>(rng()); });
+    return data;
+}
+} // namespace symcrypt_test_data
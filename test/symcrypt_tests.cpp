@@ -1,5 +1,6 @@
 #include <arba/cryp/config.hpp>
 #include <arba/cryp/symcrypt.hpp>
+#include <arba/cryp/thread_pool.hpp>
 
 #include <arba/hash/murmur_hash.hpp>
 #include <arba/rand/urng.hpp>
@@ -7,6 +8,8 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <memory_resource>
+#include <stdexcept>
 #include <ranges>
 
 auto long_data()
@@ -290,3 +293,434 @@ TEST(symcrypt_tests, test_diversity)
     std::size_t number_of_positive_counters = std::ranges::count_if(byte_counters, counter_is_positive);
     ASSERT_GT(number_of_positive_counters, byte_counters.size() * 0.60);
 }
+
+TEST(symcrypt_tests, test_execution_policies)
+{
+    cryp::symcrypt::crypto_key key{ 0xa8, 0x69, 0xad, 0x09, 0x1e, 0x02, 0x45, 0x2b,
+                                    0x81, 0xc8, 0x2e, 0xfc, 0x5d, 0xfa, 0x24, 0xad };
+    std::vector<uint8_t> init_data(3 * 1024 * 1024 + 5);
+    std::ranges::generate(init_data, rand::urng_u8<0, 255>(7));
+
+    std::vector<uint8_t> sequential_data = init_data;
+    cryp::symcrypt(key, rand::urng_u8<0, 255>(42)).encrypt(sequential_data, cryp::execution_policy::sequential());
+    for (const cryp::execution_policy& policy :
+         { cryp::execution_policy::parallel(), cryp::execution_policy::parallel(2),
+           cryp::execution_policy::automatic(), cryp::execution_policy::automatic(1024, 3) })
+    {
+        cryp::symcrypt symcrypt(key, rand::urng_u8<0, 255>(42));
+        std::vector<uint8_t> data = init_data;
+        symcrypt.encrypt(data, policy);
+        ASSERT_EQ(data, sequential_data);
+        symcrypt.decrypt(data, policy);
+        ASSERT_EQ(data, init_data);
+    }
+}
+
+TEST(symcrypt_tests, test_parallel_executor)
+{
+    class counting_executor : public cryp::executor
+    {
+    public:
+        std::size_t concurrency() const override { return pool.concurrency(); }
+        void bulk_execute(std::size_t task_count, const std::function<void(std::size_t)>& task) override
+        {
+            ++bulk_execute_count;
+            pool.bulk_execute(task_count, task);
+        }
+
+        cryp::thread_pool pool{ 3 };
+        std::size_t bulk_execute_count = 0;
+    };
+
+    counting_executor exec;
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    ASSERT_EQ(&symcrypt.parallel_executor(), &cryp::default_executor());
+    symcrypt.set_parallel_executor(exec);
+    ASSERT_EQ(&symcrypt.parallel_executor(), &exec);
+
+    std::vector<uint8_t> init_data(1024 * 1024);
+    std::ranges::generate(init_data, rand::urng_u8<0, 255>(7));
+    std::vector<uint8_t> data = init_data;
+    symcrypt.encrypt(data, cryp::execution_policy::parallel());
+    symcrypt.decrypt(data, cryp::execution_policy::parallel());
+    ASSERT_EQ(data, init_data);
+    if (std::thread::hardware_concurrency() > 1)
+    {
+        ASSERT_EQ(exec.bulk_execute_count, 2);
+    }
+}
+
+TEST(symcrypt_tests, test_random_bytes_generator)
+{
+    cryp::symcrypt::crypto_key key{ 0xa8, 0x69, 0xad, 0x09, 0x1e, 0x02, 0x45, 0x2b,
+                                    0x81, 0xc8, 0x2e, 0xfc, 0x5d, 0xfa, 0x24, 0xad };
+    std::size_t call_count = 0;
+    rand::urng_u8<0, 255> rng(42);
+    cryp::random_bytes_function generator = [&](std::span<uint8_t> bytes)
+    {
+        ++call_count;
+        std::ranges::generate(bytes, std::ref(rng));
+    };
+    cryp::symcrypt symcrypt(key, generator);
+    ASSERT_FALSE(symcrypt.random_number_generator());
+    ASSERT_TRUE(symcrypt.random_bytes_generator());
+
+    std::vector<uint8_t> init_data = short_data();
+    std::vector<uint8_t> data = init_data;
+    symcrypt.encrypt(data);
+    ASSERT_EQ(call_count, 1);
+    std::vector<uint8_t> expected_data = init_data;
+    cryp::symcrypt(key, rand::urng_u8<0, 255>(42)).encrypt(expected_data);
+    ASSERT_EQ(data, expected_data);
+    symcrypt.decrypt(data);
+    ASSERT_EQ(data, init_data);
+}
+
+TEST(symcrypt_tests, test_encrypted_size)
+{
+    ASSERT_EQ(cryp::symcrypt::encrypted_size(0), cryp::symcrypt::min_encrypted_size);
+    ASSERT_EQ(cryp::symcrypt::encrypted_size(16), cryp::symcrypt::min_encrypted_size);
+    ASSERT_EQ(cryp::symcrypt::encrypted_size(17), cryp::symcrypt::min_encrypted_size + 1);
+    ASSERT_EQ(cryp::symcrypt::encrypted_size(1000), 1000 + cryp::symcrypt::trailer_size);
+
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    for (std::size_t size : { 0, 2, 16, 17, 1000 })
+    {
+        std::vector<uint8_t> data(size, 42);
+        symcrypt.encrypt(data);
+        ASSERT_EQ(data.size(), cryp::symcrypt::encrypted_size(size));
+        ASSERT_EQ(symcrypt.decrypted_size(std::as_bytes(std::span(data))), size);
+    }
+}
+
+TEST(symcrypt_tests, test_encrypt_span)
+{
+    cryp::symcrypt::crypto_key key{ 0xa8, 0x69, 0xad, 0x09, 0x1e, 0x02, 0x45, 0x2b,
+                                    0x81, 0xc8, 0x2e, 0xfc, 0x5d, 0xfa, 0x24, 0xad };
+    for (std::vector<uint8_t> init_data : { empty_data(), short_data(), long_data(), std::vector<uint8_t>(5000, 7) })
+    {
+        std::vector<uint8_t> expected_data = init_data;
+        cryp::symcrypt(key, rand::urng_u8<0, 255>(42)).encrypt(expected_data);
+
+        cryp::symcrypt symcrypt(key, rand::urng_u8<0, 255>(42));
+        std::vector<uint8_t> encrypted_data(cryp::symcrypt::encrypted_size(init_data.size()));
+        std::size_t encrypted_size =
+            symcrypt.encrypt(std::as_bytes(std::span(init_data)), std::as_writable_bytes(std::span(encrypted_data)));
+        ASSERT_EQ(encrypted_size, encrypted_data.size());
+        ASSERT_EQ(encrypted_data, expected_data);
+
+        std::vector<uint8_t> decrypted_data(init_data.size());
+        std::size_t decrypted_size = symcrypt.decrypt(std::as_bytes(std::span(encrypted_data)),
+                                                      std::as_writable_bytes(std::span(decrypted_data)));
+        ASSERT_EQ(decrypted_size, init_data.size());
+        ASSERT_EQ(decrypted_data, init_data);
+    }
+}
+
+TEST(symcrypt_tests, test_encrypt_in_place)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    std::vector<uint8_t> init_data = seq_data();
+    std::vector<uint8_t> buffer(64);
+    std::ranges::copy(init_data, buffer.begin());
+
+    std::size_t encrypted_size = symcrypt.encrypt_in_place(std::as_writable_bytes(std::span(buffer)), init_data.size());
+    ASSERT_EQ(encrypted_size, cryp::symcrypt::encrypted_size(init_data.size()));
+    std::size_t decrypted_size =
+        symcrypt.decrypt_in_place(std::as_writable_bytes(std::span(buffer).first(encrypted_size)));
+    ASSERT_EQ(decrypted_size, init_data.size());
+    ASSERT_TRUE(std::ranges::equal(std::span(buffer).first(decrypted_size), init_data));
+}
+
+TEST(symcrypt_tests, test_span_too_small)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    std::vector<uint8_t> data = long_data();
+    std::vector<uint8_t> output(cryp::symcrypt::encrypted_size(data.size()) - 1);
+    ASSERT_THROW(symcrypt.encrypt(std::as_bytes(std::span(data)), std::as_writable_bytes(std::span(output))),
+                 std::invalid_argument);
+    ASSERT_THROW(symcrypt.encrypt_in_place(std::as_writable_bytes(std::span(data)), data.size()),
+                 std::invalid_argument);
+
+    symcrypt.encrypt(data);
+    std::vector<uint8_t> decrypted_data(long_data().size() - 1);
+    ASSERT_THROW(symcrypt.decrypt(std::as_bytes(std::span(data)), std::as_writable_bytes(std::span(decrypted_data))),
+                 std::invalid_argument);
+    std::vector<uint8_t> truncated_data(cryp::symcrypt::min_encrypted_size - 1);
+    ASSERT_THROW(symcrypt.decrypt(truncated_data), std::invalid_argument);
+}
+
+TEST(symcrypt_tests, test_batch)
+{
+    cryp::symcrypt::crypto_key key{ 0xa8, 0x69, 0xad, 0x09, 0x1e, 0x02, 0x45, 0x2b,
+                                    0x81, 0xc8, 0x2e, 0xfc, 0x5d, 0xfa, 0x24, 0xad };
+    std::size_t call_count = 0;
+    rand::urng_u8<0, 255> rng(42);
+    cryp::symcrypt symcrypt(key,
+                            [&](std::span<uint8_t> bytes)
+                            {
+                                ++call_count;
+                                std::ranges::generate(bytes, std::ref(rng));
+                            });
+
+    std::vector<std::vector<uint8_t>> init_messages{ empty_data(), short_data(), long_data(), zero_data(),
+                                                     std::vector<uint8_t>(5000, 3) };
+    for (std::size_t i = 0; i < 1000; ++i)
+        init_messages.push_back(std::vector<uint8_t>(i % 40, static_cast<uint8_t>(i)));
+    std::vector<std::span<const std::byte>> messages;
+    for (const std::vector<uint8_t>& message : init_messages)
+        messages.push_back(std::as_bytes(std::span(message)));
+
+    for (cryp::execution_policy policy : { cryp::execution_policy::sequential(), cryp::execution_policy::parallel() })
+    {
+        call_count = 0;
+        std::vector<std::byte> encrypted_batch(cryp::symcrypt::encrypted_batch_size(messages));
+        ASSERT_EQ(symcrypt.encrypt_batch(messages, encrypted_batch, policy), encrypted_batch.size());
+        ASSERT_EQ(call_count, 1);
+
+        std::vector<std::span<const std::byte>> encrypted_messages;
+        std::span<const std::byte> remaining_bytes = encrypted_batch;
+        for (const std::vector<uint8_t>& message : init_messages)
+        {
+            const std::size_t encrypted_size = cryp::symcrypt::encrypted_size(message.size());
+            encrypted_messages.push_back(remaining_bytes.first(encrypted_size));
+            remaining_bytes = remaining_bytes.subspan(encrypted_size);
+            std::vector<uint8_t> decrypted_message(message.size());
+            symcrypt.decrypt(encrypted_messages.back(), std::as_writable_bytes(std::span(decrypted_message)));
+            ASSERT_EQ(decrypted_message, message);
+        }
+
+        std::vector<std::byte> decrypted_batch(symcrypt.decrypted_batch_size(encrypted_messages));
+        std::vector<std::size_t> message_sizes(encrypted_messages.size());
+        ASSERT_EQ(symcrypt.decrypt_batch(encrypted_messages, decrypted_batch, message_sizes, policy),
+                  decrypted_batch.size());
+        std::span<const std::byte> decrypted_bytes = decrypted_batch;
+        for (std::size_t i = 0; i < init_messages.size(); ++i)
+        {
+            ASSERT_EQ(message_sizes[i], init_messages[i].size());
+            ASSERT_TRUE(std::ranges::equal(decrypted_bytes.first(message_sizes[i]),
+                                           std::as_bytes(std::span(init_messages[i]))));
+            decrypted_bytes = decrypted_bytes.subspan(message_sizes[i]);
+        }
+
+        std::vector<std::byte> small_output(decrypted_batch.size() - 1);
+        ASSERT_THROW(symcrypt.decrypt_batch(encrypted_messages, small_output, message_sizes, policy),
+                     std::invalid_argument);
+    }
+}
+
+TEST(symcrypt_tests, test_encrypt_decrypt_pmr_vector)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    std::array<std::byte, 4096> arena;
+    std::pmr::monotonic_buffer_resource resource(arena.data(), arena.size(), std::pmr::null_memory_resource());
+    for (std::size_t data_size : { 0, 5, 16, 17, 100 })
+    {
+        std::pmr::vector<uint8_t> data(data_size, &resource);
+        std::ranges::generate(data, rand::urng_u8<0, 255>(data_size));
+        std::pmr::vector<uint8_t> bytes(data, &resource);
+        symcrypt.encrypt(bytes);
+        ASSERT_EQ(bytes.size(), cryp::symcrypt::encrypted_size(data_size));
+        ASSERT_EQ(bytes.get_allocator().resource(), &resource);
+        symcrypt.decrypt(bytes);
+        ASSERT_EQ(bytes, data);
+    }
+}
+
+TEST(symcrypt_tests, test_encrypt_decrypt_scattered)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    for (std::size_t data_size : { 0, 5, 16, 17, 100, 200000 })
+    {
+        std::vector<uint8_t> data(data_size);
+        std::ranges::generate(data, rand::urng_u8<0, 255>(data_size));
+        // Fragments of a message: a header, an empty fragment and a body.
+        std::vector<std::byte> message(std::as_bytes(std::span(data)).begin(), std::as_bytes(std::span(data)).end());
+        const std::size_t header_size = std::min<std::size_t>(data_size, 3);
+        const std::array<std::span<std::byte>, 3> fragments{ std::span(message).first(header_size),
+                                                             std::span<std::byte>(),
+                                                             std::span(message).subspan(header_size) };
+        std::vector<std::byte> trailer(cryp::symcrypt::scattered_trailer_size(data_size));
+        ASSERT_EQ(symcrypt.encrypt_scattered(fragments, trailer, cryp::execution_policy::parallel()), trailer.size());
+
+        // The concatenation is the usual encrypted message.
+        std::vector<uint8_t> encrypted_data(data_size + trailer.size());
+        std::ranges::copy(std::as_bytes(std::span(message)), reinterpret_cast<std::byte*>(encrypted_data.data()));
+        std::ranges::copy(trailer, reinterpret_cast<std::byte*>(encrypted_data.data()) + data_size);
+        ASSERT_EQ(encrypted_data.size(), cryp::symcrypt::encrypted_size(data_size));
+        std::vector<uint8_t> decrypted_data = encrypted_data;
+        symcrypt.decrypt(decrypted_data);
+        ASSERT_EQ(decrypted_data, data);
+
+        // The trailer may be split between fragments when decrypting.
+        const std::size_t split_index = trailer.size() / 2;
+        const std::array<std::span<std::byte>, 3> encrypted_fragments{ std::span(message),
+                                                                       std::span(trailer).first(split_index),
+                                                                       std::span(trailer).subspan(split_index) };
+        ASSERT_EQ(symcrypt.decrypt_scattered(encrypted_fragments, cryp::execution_policy::parallel()), data_size);
+        ASSERT_TRUE(std::ranges::equal(message, std::as_bytes(std::span(data))));
+    }
+
+    std::vector<std::byte> small_trailer(cryp::symcrypt::trailer_size - 1);
+    std::vector<std::byte> message(100);
+    const std::array<std::span<std::byte>, 1> fragments{ std::span(message) };
+    ASSERT_THROW(symcrypt.encrypt_scattered(fragments, small_trailer), std::invalid_argument);
+    const std::array<std::span<std::byte>, 1> small_fragments{ std::span(message).first(10) };
+    ASSERT_THROW(symcrypt.decrypt_scattered(small_fragments), std::invalid_argument);
+}
+
+TEST(symcrypt_tests, test_encrypt_with_random_bytes)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    for (std::size_t data_size : { 0, 5, 16, 17, 200000 })
+    {
+        std::vector<uint8_t> data(data_size);
+        std::ranges::generate(data, rand::urng_u8<0, 255>(data_size));
+        const cryp::symcrypt::random_bytes_array random_bytes = symcrypt.draw_random_bytes(data_size);
+        std::vector<std::byte> encrypted_data(cryp::symcrypt::encrypted_size(data_size));
+        ASSERT_EQ(symcrypt.encrypt(std::as_bytes(std::span(data)), encrypted_data, random_bytes,
+                                   cryp::execution_policy::parallel()),
+                  encrypted_data.size());
+        std::vector<std::byte> decrypted_data(encrypted_data.size());
+        ASSERT_EQ(symcrypt.decrypt(encrypted_data, decrypted_data), data_size);
+        ASSERT_TRUE(std::ranges::equal(std::span(decrypted_data).first(data_size), std::as_bytes(std::span(data))));
+
+        // The same random bytes give the same trailer, and the keystream of the data.
+        std::vector<std::byte> trailer(cryp::symcrypt::scattered_trailer_size(data_size));
+        const cryp::keystream kstream = symcrypt.encrypt_trailer(data_size, random_bytes, trailer);
+        ASSERT_TRUE(std::ranges::equal(trailer, std::span(encrypted_data).subspan(data_size)));
+        std::vector<uint8_t> encrypted_bytes(data_size);
+        kstream.encrypt(data.data(), encrypted_bytes.data(), data_size);
+        ASSERT_TRUE(std::ranges::equal(std::as_bytes(std::span(encrypted_bytes)),
+                                       std::span(encrypted_data).first(data_size)));
+
+        // The offsets retrieved from the end of the ciphertext give the same keystream.
+        const std::span<const std::byte> ciphertext(encrypted_data);
+        const cryp::keystream retrieved_kstream(
+            *symcrypt.shared_key_schedule(),
+            cryp::symcrypt::retrieve_offsets(*symcrypt.shared_key_schedule(),
+                                             ciphertext.last<cryp::keystream::offsets_size>()));
+        ASSERT_TRUE(std::ranges::equal(std::span(retrieved_kstream.data(), kstream.size()),
+                                       std::span(kstream.data(), kstream.size())));
+    }
+
+    const cryp::symcrypt::random_bytes_array random_bytes = symcrypt.draw_random_bytes(100);
+    std::vector<std::byte> data(100);
+    std::vector<std::byte> small_output(cryp::symcrypt::encrypted_size(100) - 1);
+    ASSERT_THROW(symcrypt.encrypt(data, small_output, random_bytes), std::invalid_argument);
+    std::vector<std::byte> small_trailer(cryp::symcrypt::trailer_size - 1);
+    ASSERT_THROW(symcrypt.encrypt_trailer(100, random_bytes, small_trailer), std::invalid_argument);
+}
+
+TEST(symcrypt_tests, test_reencrypt)
+{
+    const cryp::symcrypt::crypto_key old_key = cryp::symcrypt::to_crypto_key("old password");
+    cryp::symcrypt old_symcrypt(old_key);
+    cryp::symcrypt symcrypt(std::string_view("new password"));
+    for (std::size_t data_size : { 0, 5, 16, 17, 100, 5000, 200000 })
+    {
+        std::vector<uint8_t> data(data_size);
+        std::ranges::generate(data, rand::urng_u8<0, 255>(data_size));
+        std::vector<uint8_t> bytes = data;
+        old_symcrypt.encrypt(bytes);
+        const std::vector<uint8_t> encrypted_data = bytes;
+        symcrypt.reencrypt(old_key, bytes, cryp::execution_policy::parallel());
+        ASSERT_EQ(bytes.size(), encrypted_data.size());
+        ASSERT_NE(bytes, encrypted_data);
+        std::vector<uint8_t> decrypted_data = bytes;
+        symcrypt.decrypt(decrypted_data);
+        ASSERT_EQ(decrypted_data, data);
+
+        // Back to the old key, with its key schedule.
+        old_symcrypt.reencrypt(*symcrypt.shared_key_schedule(), std::as_writable_bytes(std::span(bytes)));
+        old_symcrypt.decrypt(bytes);
+        ASSERT_EQ(bytes, data);
+    }
+
+    std::vector<uint8_t> small_data(cryp::symcrypt::min_encrypted_size - 1);
+    ASSERT_THROW(symcrypt.reencrypt(old_key, small_data), std::invalid_argument);
+}
+
+TEST(symcrypt_tests, test_encrypt_decrypt_checked)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    for (std::size_t data_size : { 0, 5, 8, 16, 17, 100, 200000 })
+    {
+        std::vector<uint8_t> data(data_size);
+        std::ranges::generate(data, rand::urng_u8<0, 255>(data_size));
+        std::vector<uint8_t> bytes = data;
+        symcrypt.encrypt_checked(bytes, cryp::execution_policy::parallel());
+        ASSERT_EQ(bytes.size(), cryp::symcrypt::checked_encrypted_size(data_size));
+
+        std::vector<std::byte> output(data_size);
+        ASSERT_EQ(symcrypt.decrypt_checked(std::as_bytes(std::span(bytes)), output), data_size);
+        ASSERT_TRUE(std::ranges::equal(output, std::as_bytes(std::span(data))));
+
+        // A corrupted byte of the data, at the beginning, in the middle or at the end, or of the checksums.
+        for (std::size_t corrupted_index : { std::size_t(0), data_size / 2, data_size + 1 })
+        {
+            std::vector<uint8_t> corrupted_bytes = bytes;
+            corrupted_bytes[corrupted_index] ^= 1;
+            const std::vector<uint8_t> encrypted_corrupted_bytes = corrupted_bytes;
+            for (const cryp::execution_policy& policy :
+                 { cryp::execution_policy::sequential(), cryp::execution_policy::parallel() })
+            {
+                ASSERT_THROW(symcrypt.decrypt_checked(corrupted_bytes, policy), std::invalid_argument);
+                // The unverified data are not left in output.
+                ASSERT_EQ(corrupted_bytes, encrypted_corrupted_bytes);
+                std::ranges::fill(output, std::byte(1));
+                ASSERT_THROW(symcrypt.decrypt_checked(std::as_bytes(std::span(corrupted_bytes)), output, policy),
+                             std::invalid_argument);
+                ASSERT_TRUE(std::ranges::all_of(output, [](std::byte byte) { return byte == std::byte(0); }));
+            }
+        }
+
+        symcrypt.decrypt_checked(bytes, cryp::execution_policy::parallel());
+        ASSERT_EQ(bytes, data);
+    }
+
+    std::vector<uint8_t> unchecked_bytes(5);
+    symcrypt.encrypt(unchecked_bytes);
+    ASSERT_THROW(symcrypt.decrypt_checked(unchecked_bytes), std::invalid_argument);
+    // No data size gives a message of checksum_block_size + 9 bytes with its checksums.
+    std::vector<uint8_t> unchecked_block_bytes(cryp::symcrypt::checksum_block_size + 9);
+    symcrypt.encrypt(unchecked_block_bytes);
+    ASSERT_THROW(symcrypt.decrypt_checked(unchecked_block_bytes), std::invalid_argument);
+    std::vector<std::byte> output(cryp::symcrypt::checked_encrypted_size(10) - 1);
+    ASSERT_THROW(symcrypt.encrypt_checked(std::span(output).first(10), output), std::invalid_argument);
+}
+
+TEST(symcrypt_tests, test_checksum_golden)
+{
+    // The checksums are part of the format of the checked encryption: their blocks must not depend on the parallel
+    // execution.
+    constexpr std::size_t golden_block_size = 64512;
+    ASSERT_EQ(cryp::symcrypt::checksum_block_size, golden_block_size);
+    std::vector<uint8_t> data(2 * golden_block_size + 1000);
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<uint8_t>(i * 7 % 251);
+    std::vector<uint64_t> golden_checksums;
+    for (std::size_t offset = 0; offset < data.size(); offset += golden_block_size)
+        golden_checksums.push_back(
+            hash::neutral_murmur_hash_64(data.data() + offset, std::min(golden_block_size, data.size() - offset)));
+    ASSERT_EQ(cryp::symcrypt::checksum_count(data.size()), golden_checksums.size());
+
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    for (const cryp::execution_policy& policy :
+         { cryp::execution_policy::sequential(), cryp::execution_policy::parallel() })
+    {
+        // Decrypted as an unchecked message, the checksums follow the data.
+        std::vector<uint8_t> bytes = data;
+        symcrypt.encrypt_checked(bytes, policy);
+        symcrypt.decrypt(bytes);
+        ASSERT_EQ(bytes.size(), data.size() + golden_checksums.size() * cryp::symcrypt::checksum_size);
+        for (std::size_t block_index = 0; block_index < golden_checksums.size(); ++block_index)
+        {
+            const uint8_t* checksum_bytes = &bytes[data.size() + block_index * cryp::symcrypt::checksum_size];
+            uint64_t checksum = 0;
+            for (std::size_t i = cryp::symcrypt::checksum_size; i-- > 0;)
+                checksum = (checksum << 8) | checksum_bytes[i];
+            ASSERT_EQ(checksum, golden_checksums[block_index]);
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#include <arba/cryp/symcrypt.hpp>
+#include <arba/cryp/symcrypt_view.hpp>
+
+#include <gtest/gtest.h>
+
+#include "symcrypt_test_data.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static_assert(std::ranges::random_access_range<cryp::decrypted_view>);
+static_assert(std::ranges::sized_range<cryp::decrypted_view>);
+static_assert(std::ranges::view<cryp::decrypted_view>);
+static_assert(std::ranges::random_access_range<cryp::encrypted_view>);
+static_assert(std::ranges::view<cryp::encrypted_view>);
+
+namespace
+{
+using symcrypt_test_data::make_data;
+} // namespace
+
+TEST(symcrypt_view_tests, test_decrypted_view)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    for (std::size_t data_size : { 0, 3, 16, 17, 10000 })
+    {
+        const std::vector<uint8_t> data = make_data<uint8_t>(data_size);
+        std::vector<uint8_t> ciphertext = data;
+        symcrypt.encrypt(ciphertext);
+        const std::vector<uint8_t> encrypted_data = ciphertext;
+
+        const cryp::decrypted_view view = ciphertext | cryp::views::decrypted(symcrypt);
+        ASSERT_EQ(view.size(), data_size);
+        ASSERT_TRUE(std::ranges::equal(view, std::as_bytes(std::span(data))));
+        ASSERT_EQ(ciphertext, encrypted_data);
+        // Random access, backwards.
+        for (std::size_t i = data_size; i-- > 0;)
+            ASSERT_EQ(view[i], std::byte(data[i]));
+
+        const std::size_t offset = data_size / 3;
+        std::vector<std::byte> block(data_size - offset);
+        view.copy_to(offset, block);
+        ASSERT_TRUE(std::ranges::equal(block, std::as_bytes(std::span(data).subspan(offset))));
+        ASSERT_THROW(view.copy_to(offset + 1, block), std::out_of_range);
+    }
+
+    std::vector<uint8_t> small_ciphertext(cryp::symcrypt::min_encrypted_size - 1);
+    ASSERT_THROW(small_ciphertext | cryp::views::decrypted(symcrypt), std::invalid_argument);
+}
+
+TEST(symcrypt_view_tests, test_decrypted_view_early_stop)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    const std::string text = "key=value;other=data";
+    std::vector<uint8_t> ciphertext(text.begin(), text.end());
+    symcrypt.encrypt(ciphertext);
+
+    const cryp::decrypted_view view(symcrypt, std::as_bytes(std::span(ciphertext)));
+    auto iter = std::ranges::find(view, std::byte('='));
+    ASSERT_EQ(iter - view.begin(), 3);
+    auto chars = view | std::views::take_while([](std::byte byte) { return byte != std::byte(';'); })
+                 | std::views::transform([](std::byte byte) { return static_cast<char>(byte); });
+    std::string key_value;
+    std::ranges::copy(chars, std::back_inserter(key_value));
+    ASSERT_EQ(key_value, "key=value");
+}
+
+TEST(symcrypt_view_tests, test_encrypted_view)
+{
+    cryp::symcrypt symcrypt(std::string_view("password"));
+    for (std::size_t data_size : { 0, 3, 16, 17, 10000 })
+    {
+        const std::vector<uint8_t> data = make_data<uint8_t>(data_size);
+        const cryp::encrypted_view view = data | cryp::views::encrypted(symcrypt);
+        ASSERT_EQ(view.size(), cryp::symcrypt::encrypted_size(data_size));
+
+        std::vector<uint8_t> ciphertext(view.size());
+        std::ranges::transform(view, ciphertext.begin(), [](std::byte byte) { return static_cast<uint8_t>(byte); });
+        std::vector<std::byte> block(view.size());
+        view.copy_to(0, block);
+        ASSERT_TRUE(std::ranges::equal(block, std::as_bytes(std::span(ciphertext))));
+        const std::size_t offset = data_size / 2;
+        view.copy_to(offset, std::span(block).first(view.size() - offset));
+        ASSERT_TRUE(std::ranges::equal(std::span(block).first(view.size() - offset),
+                                       std::as_bytes(std::span(ciphertext).subspan(offset))));
+
+        symcrypt.decrypt(ciphertext);
+        ASSERT_EQ(ciphertext, data);
+    }
+}
@@ -0,0 +1,92 @@
+#include <arba/cryp/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST(thread_pool_tests, test_concurrency)
+{
+    cryp::thread_pool pool(3);
+    ASSERT_EQ(pool.concurrency(), 3);
+}
+
+TEST(thread_pool_tests, test_bulk_execute)
+{
+    for (std::size_t thread_count : { 0, 1, 4 })
+    {
+        cryp::thread_pool pool(thread_count);
+        std::vector<std::atomic_int> counters(1000);
+        pool.bulk_execute(counters.size(), [&](std::size_t index) { ++counters[index]; });
+        for (const std::atomic_int& counter : counters)
+            ASSERT_EQ(counter.load(), 1);
+    }
+}
+
+TEST(thread_pool_tests, test_nested_bulk_execute)
+{
+    cryp::thread_pool pool(2);
+    std::atomic_int counter = 0;
+    pool.bulk_execute(8, [&](std::size_t) { pool.bulk_execute(8, [&](std::size_t) { ++counter; }); });
+    ASSERT_EQ(counter.load(), 64);
+}
+
+TEST(thread_pool_tests, test_bulk_execute_exception)
+{
+    cryp::thread_pool pool(2);
+    std::atomic_int counter = 0;
+    auto task = [&](std::size_t index)
+    {
+        ++counter;
+        if (index == 5)
+            throw std::runtime_error("task failure");
+    };
+    ASSERT_THROW(pool.bulk_execute(10, task), std::runtime_error);
+    ASSERT_EQ(counter.load(), 10);
+}
+
+TEST(thread_pool_tests, test_submit)
+{
+    std::atomic_int counter = 0;
+    {
+        cryp::thread_pool pool(2);
+        for (int i = 0; i < 100; ++i)
+            pool.submit([&counter] { ++counter; });
+    }
+    ASSERT_EQ(counter.load(), 100);
+}
+
+TEST(thread_pool_tests, test_submit_exception)
+{
+    std::atomic_int counter = 0;
+    {
+        cryp::thread_pool pool(2);
+        for (int i = 0; i < 100; ++i)
+            pool.submit(
+                [&counter, i]
+                {
+                    ++counter;
+                    if (i % 3 == 0)
+                        throw std::runtime_error("task failure");
+                });
+        // bulk_execute() is not affected by the failures of the submitted tasks it may run.
+        std::atomic_int bulk_counter = 0;
+        pool.bulk_execute(10, [&](std::size_t) { ++bulk_counter; });
+        ASSERT_EQ(bulk_counter.load(), 10);
+    }
+    ASSERT_EQ(counter.load(), 100);
+
+    cryp::thread_pool inline_pool(0);
+    ASSERT_NO_THROW(inline_pool.submit([] { throw std::runtime_error("task failure"); }));
+}
+
+TEST(thread_pool_tests, test_default_executor)
+{
+    cryp::executor& exec = cryp::default_executor();
+    cryp::thread_pool pool(1);
+    cryp::set_default_executor(pool);
+    ASSERT_EQ(&cryp::default_executor(), &pool);
+    cryp::set_default_executor(exec);
+    ASSERT_EQ(&cryp::default_executor(), &exec);
+}